@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    The colour scheme shared by every editor.
+
+  ==============================================================================
+*/
+
+#include "CombinerLookAndFeel.h"
+
+CombinerLookAndFeel::CombinerLookAndFeel()
+{
+    setColour(juce::Label::textColourId, POWDER_BLUE);
+
+    setColour(juce::Slider::thumbColourId, HONEYDEW);
+    setColour(juce::Slider::rotarySliderFillColourId, CALEDON_BLUE);
+    setColour(juce::Slider::rotarySliderOutlineColourId, POWDER_BLUE);
+    setColour(juce::Slider::textBoxTextColourId, POWDER_BLUE);
+    setColour(juce::Slider::textBoxOutlineColourId, CALEDON_BLUE);
+
+    setColour(juce::TextButton::buttonColourId, POWDER_BLUE);
+    setColour(juce::TextButton::buttonOnColourId, CALEDON_BLUE);
+    setColour(juce::TextButton::textColourOffId, CALEDON_BLUE);
+    setColour(juce::TextButton::textColourOnId, POWDER_BLUE);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+* CombinerLookAndFeel
+* The colour scheme of the editor. Held through a SharedResourcePointer, so it is only built
+* when the first editor opens and is shared by every open editor in the process, and the
+* default look and feel used by the host and other plugins is left untouched.
+* @author Ryan Logan
+*
+*/
+class CombinerLookAndFeel : public juce::LookAndFeel_V4
+{
+public:
+    // Colours
+    const juce::Colour HONEYDEW = juce::Colour(0xD8, 0xF1, 0xD0);
+    const juce::Colour POWDER_BLUE = juce::Colour(0xA8, 0xDA, 0xDC);
+    const juce::Colour CALEDON_BLUE = juce::Colour(0x45, 0x7B, 0x9D);
+    const juce::Colour PRUSSIAN_BLUE = juce::Colour(0x1D, 0x35, 0x57);
+
+    CombinerLookAndFeel();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CombinerLookAndFeel)
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    The C interface to the crossover.
+
+  ==============================================================================
+*/
+
+#include "CombinerCore.h"
+#include "Crossover.h"
+#include <new>
+
+struct CombinerCrossover
+{
+    Crossover crossover;
+};
+
+CombinerCrossover* combiner_create(double sampleRate)
+{
+    auto* wrapper = new (std::nothrow) CombinerCrossover;
+    if (wrapper != nullptr)
+        wrapper->crossover.prepare(sampleRate);
+    return wrapper;
+}
+
+void combiner_destroy(CombinerCrossover* crossover)
+{
+    delete crossover;
+}
+
+void combiner_set_filters(CombinerCrossover* crossover, double lopass, double hipass, int slopeIndex)
+{
+    if (crossover == nullptr)
+        return;
+
+    // the memory of one slope means nothing to the filters of another
+    const int previousSlope = crossover->crossover.getSlope();
+    crossover->crossover.setCutoffs(lopass, hipass);
+    crossover->crossover.setSlope(slopeIndex);
+    crossover->crossover.update();
+    if (crossover->crossover.getSlope() != previousSlope)
+        crossover->crossover.reset();
+}
+
+void combiner_set_offline(CombinerCrossover* crossover, int offline)
+{
+    if (crossover != nullptr)
+        crossover->crossover.setOffline(offline != 0);
+}
+
+void combiner_reset(CombinerCrossover* crossover)
+{
+    if (crossover != nullptr)
+        crossover->crossover.reset();
+}
+
+void combiner_combine(CombinerCrossover* crossover, float* const* lopass, float* const* hipass,
+                      int numChannels, int numSamples)
+{
+    if (crossover == nullptr || lopass == nullptr || hipass == nullptr)
+        return;
+
+    crossover->crossover.combine({ lopass, numChannels, numSamples }, { hipass, numChannels, numSamples });
+}
+
+void combiner_split(CombinerCrossover* crossover, float* const* input, float* const* hipass,
+                    int numChannels, int numSamples)
+{
+    if (crossover == nullptr || input == nullptr || hipass == nullptr)
+        return;
+
+    crossover->crossover.split({ input, numChannels, numSamples }, { hipass, numChannels, numSamples });
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    C interface to the crossover, for programs that cannot link C++ directly.
+
+    Buffers are passed as arrays of channel pointers and are processed in place.
+    A crossover must only be used by one thread at a time.
+    Every function does nothing when passed a NULL crossover or NULL buffers.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Define as the export attribute of the platform when building the core as a shared library
+#ifndef COMBINER_CORE_API
+ #define COMBINER_CORE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct CombinerCrossover CombinerCrossover;
+
+/**
+* Creates a crossover with both cutoffs at 750 Hz and the 24 dB/8ve slope
+* @param sampleRate The sample rate of the audio to be processed
+* @return The new crossover, or NULL if it could not be allocated
+*/
+COMBINER_CORE_API CombinerCrossover* combiner_create(double sampleRate);
+
+/**
+* @param crossover A crossover from combiner_create(), or NULL
+*/
+COMBINER_CORE_API void combiner_destroy(CombinerCrossover* crossover);
+
+/**
+* Recalculates the filters. The filter memory is kept when only the cutoffs change, so this may be called between
+* blocks. A change of slope changes the order of the filters, so their memory is cleared
+* @param lopass The lopass cutoff in Hz
+* @param hipass The hipass cutoff in Hz
+* @param slopeIndex 0, 1 or 2 for the 12, 24 and 48 dB/8ve slopes
+*/
+COMBINER_CORE_API void combiner_set_filters(CombinerCrossover* crossover, double lopass, double hipass, int slopeIndex);
+
+/**
+* @param offline Non-zero when rendering offline. The block kernel is then used wherever it measures faster than the
+*                realtime kernel, and the filters restart if the kernel changes
+*/
+COMBINER_CORE_API void combiner_set_offline(CombinerCrossover* crossover, int offline);
+
+/**
+* Sets all filter memory to 0.0
+*/
+COMBINER_CORE_API void combiner_reset(CombinerCrossover* crossover);
+
+/**
+* Sums the lopass of one buffer with the hipass of another
+* @param lopass One or two channels, which receive the sum
+* @param hipass One or two channels, which are left unchanged
+* @param numChannels The number of channels in each buffer
+* @param numSamples The number of samples in each channel
+*/
+COMBINER_CORE_API void combiner_combine(CombinerCrossover* crossover, float* const* lopass, float* const* hipass,
+                                        int numChannels, int numSamples);
+
+/**
+* Splits a buffer into a lopass band, written over the input, and a hipass band
+* @param input One or two channels, which receive the lopass band
+* @param hipass One or two channels, which receive the hipass band
+* @param numChannels The number of channels in each buffer
+* @param numSamples The number of samples in each channel
+*/
+COMBINER_CORE_API void combiner_split(CombinerCrossover* crossover, float* const* input, float* const* hipass,
+                                      int numChannels, int numSamples);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,390 @@
+/*
+  ==============================================================================
+
+    Coefficients and processing for the Linkwitz-Riley crossover.
+
+    Like the rest of the core, this file must not depend on JUCE.
+
+  ==============================================================================
+*/
+
+#include "Crossover.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double pi = 3.141592653589793238;
+    constexpr double twoPi = 2.0 * pi;
+    constexpr double sqrt2 = 1.414213562373095049;
+}
+
+void Crossover::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    update();
+    reset();
+}
+
+void Crossover::reset()
+{
+    // set all sample of all lanes of memory to 0
+    kernelState = {};
+    offlineState = {};
+}
+
+void Crossover::setCutoffs(double lopass, double hipass)
+{
+    fc[0] = lopass;
+    fc[1] = hipass;
+}
+
+void Crossover::setSlope(int slopeIndex)
+{
+    slope = std::min(std::max(slopeIndex, 0), 2);
+}
+
+void Crossover::update()
+{
+    prepHelper(FilterType::lopass);
+    calculateCoefficients(FilterType::lopass);
+    calculateAllpassCoefficients();
+    prepHelper(FilterType::hipass);
+    calculateCoefficients(FilterType::hipass);
+    packCoefficients();
+    chooseKernel();
+}
+
+void Crossover::setKernel(KernelType type)
+{
+    kernel = FilterKernels::select(type);
+    chooseKernel();
+}
+
+void Crossover::setOffline(bool shouldBeOffline, bool willSplitAcrossThreads)
+{
+    offline = shouldBeOffline;
+    splitAcrossThreads = willSplitAcrossThreads;
+    chooseKernel();
+}
+
+void Crossover::chooseKernel()
+{
+    const bool useOfflineKernel = offline
+        && (splitAcrossThreads || FilterKernels::isOfflineFaster(kernel.type, kernelOrder, kernelStages));
+
+    // the offline kernel has its own memory, so the filters restart when switching to or from it
+    if (useOfflineKernel != offlineKernel)
+    {
+        reset();
+        offlineKernel = useOfflineKernel;
+    }
+}
+
+bool Crossover::isComplementary() const
+{
+    // when both bands share a cutoff, lopass + hipass is an allpass for the 12 and 24 dB/8ve slopes
+    return fc[0] == fc[1] && kernelStages == 1;
+}
+
+void Crossover::process(float* const* lanes, int numSamples, bool useSplitCoefficients, bool sumPairs)
+{
+    matchStateTo(useSplitCoefficients);
+
+    if (offlineKernel)
+        kernel.processOffline(getOfflineCoefficients(useSplitCoefficients), offlineState, lanes, numSamples, sumPairs);
+    else
+        kernel.process(useSplitCoefficients ? splitCoefficients : combineCoefficients, kernelState,
+                       lanes, numSamples, kernelOrder, kernelStages, sumPairs);
+}
+
+const OfflineCoefficients& Crossover::getOfflineCoefficients(bool useSplitCoefficients) const
+{
+    return useSplitCoefficients ? splitOffline : combineOffline;
+}
+
+OfflineState& Crossover::getOfflineState(bool useSplitCoefficients)
+{
+    matchStateTo(useSplitCoefficients);
+    return offlineState;
+}
+
+void Crossover::matchStateTo(bool useSplitCoefficients)
+{
+    if (useSplitCoefficients == stateUsesSplitCoefficients)
+        return;
+
+    for (int lane{ 2 }; lane < kernelLanes; ++lane)
+    {
+        for (int stage{ 0 }; stage < 2; ++stage)
+        {
+            for (int tap{ 0 }; tap < 5; ++tap)
+            {
+                kernelState.x[stage][tap][lane] = 0.0;
+                kernelState.y[stage][tap][lane] = 0.0;
+            }
+        }
+
+        for (int section{ 0 }; section < maxSections; ++section)
+        {
+            for (int tap{ 0 }; tap < 3; ++tap)
+            {
+                offlineState.x[section][tap][lane] = 0.0;
+                offlineState.y[section][tap][lane] = 0.0;
+            }
+        }
+    }
+
+    stateUsesSplitCoefficients = useSplitCoefficients;
+}
+
+void Crossover::combine(AudioSpan lopass, AudioSpan hipass)
+{
+    float* scratchLanes[kernelLanes];
+    combineTiles(lopass, hipass, getScratch(scratchLanes), tileLength,
+                 [this](float* const* lanes, int numSamples) { process(lanes, numSamples, false, true); });
+}
+
+void Crossover::split(AudioSpan input, AudioSpan hipass)
+{
+    const bool complementary = isComplementary();
+
+    float* scratchLanes[kernelLanes];
+    splitTiles(input, hipass, getScratch(scratchLanes), tileLength, complementary,
+               [this, complementary](float* const* lanes, int numSamples) { process(lanes, numSamples, complementary, false); });
+}
+
+void Crossover::getTileLanes(float* (&lanes)[kernelLanes], AudioSpan lopass, AudioSpan hipass, AudioSpan scratch,
+                             int startSample, int numSamples)
+{
+    for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+    {
+        lanes[channelNo] = channelNo < lopass.numChannels ? lopass.channels[channelNo] + startSample : scratch.channels[channelNo];
+        lanes[channelNo + 2] = channelNo < hipass.numChannels ? hipass.channels[channelNo] + startSample : scratch.channels[channelNo + 2];
+    }
+
+    for (int lane{ 0 }; lane < kernelLanes; ++lane)
+        if (lanes[lane] == scratch.channels[lane])
+            std::fill(lanes[lane], lanes[lane] + numSamples, 0.0f);
+}
+
+AudioSpan Crossover::getScratch(float* (&lanes)[kernelLanes])
+{
+    for (int lane{ 0 }; lane < kernelLanes; ++lane)
+        lanes[lane] = scratch[lane];
+
+    return { lanes, kernelLanes, tileLength };
+}
+
+void Crossover::prepHelper(FilterType type)
+{
+    switch (slope)
+    {
+    case 0:
+        prepHelper2(type);
+        break;
+    case 1:
+        prepHelper4(type);
+        break;
+    default:
+        prepHelper8(type);
+        break;
+    }
+}
+
+void Crossover::prepHelper2(FilterType type)
+{
+    int i = type == FilterType::lopass ? 0 : 1;
+
+    w[i][1] = pi * fc[i];
+    w[i][2] = w[i][1] * w[i][1];
+    k[i][1] = w[i][1] / tan(w[i][1] / sampleRate);
+    k[i][2] = k[i][1] * k[i][1];
+
+    tmp1 = 2 * k[i][1] * w[i][1];
+    tmp2 = k[i][2] + w[i][2] + tmp1;
+}
+
+void Crossover::prepHelper4(FilterType type)
+{
+    int i = type == FilterType::lopass ? 0 : 1;
+
+    w[i][1] = twoPi * fc[i];
+    w[i][2] = w[i][1] * w[i][1];
+    w[i][3] = w[i][2] * w[i][1];
+    w[i][4] = w[i][2] * w[i][2];
+
+    k[i][1] = w[i][1] / tan(pi * fc[i] / sampleRate);
+    k[i][2] = k[i][1] * k[i][1];
+    k[i][3] = k[i][2] * k[i][1];
+    k[i][4] = k[i][2] * k[i][2];
+
+    tmp1 = sqrt2 * w[i][3] * k[i][1];
+    tmp2 = sqrt2 * w[i][1] * k[i][3];
+    tmp_a = 4 * w[i][2] * k[i][2] + 2 * tmp1 + k[i][4] + 2 * tmp2 + w[i][4];
+}
+
+void Crossover::prepHelper8(FilterType type) 
+{
+    prepHelper4(type);
+}
+
+void Crossover::calculateCoefficients(FilterType type)
+{
+    switch (slope)
+    {
+    case 0:
+        calculateCoefficients2(type);
+        break;
+    case 1:
+        calculateCoefficients4(type);
+        break;
+    default:
+        calculateCoefficients8(type);
+        break;
+    }
+}
+
+void Crossover::calculateCoefficients2(FilterType type)
+{
+    int i = type == FilterType::lopass ? 0 : 1;
+
+    a[i][0] = (type == FilterType::lopass ? w[i][2] : k[i][2]) / tmp2;
+    a[i][1] = (type == FilterType::lopass ? (2.0 * w[i][2]) : (-2.0 * k[i][2])) / tmp2;
+    a[i][2] = a[i][0];
+
+    b[i][1] = (2.0 * w[i][2] - 2.0 * k[i][2]) / tmp2;
+    b[i][2] = (k[i][2] + w[i][2] - tmp1) / tmp2;
+}
+
+void Crossover::calculateCoefficients4(FilterType type)
+{
+    int i = type == FilterType::lopass ? 0 : 1;
+
+    b[i][1] = (4 * (w[i][4] + tmp1 - k[i][4] - tmp2)) / tmp_a;
+    b[i][2] = (6 * w[i][4] - 8 * w[i][2] * k[i][2] + 6 * k[i][4]) / tmp_a;
+    b[i][3] = (4 * (w[i][4] - tmp1 + tmp2 - k[i][4])) / tmp_a;
+    b[i][4] = (k[i][4] - 2 * tmp1 + w[i][4] - 2 * tmp2 + 4 * w[i][2] * k[i][2]) / tmp_a;
+
+    a[i][0] = (type == FilterType::lopass ? w[i][4] : k[i][4]) / tmp_a;
+    a[i][1] = (type == FilterType::lopass ? 4 : -4) * a[i][0];
+    a[i][2] = 6 * a[i][0];
+    a[i][3] = a[i][1];
+    a[i][4] = a[i][0];
+}
+
+void Crossover::calculateCoefficients8(FilterType type)
+{
+    calculateCoefficients4(type);
+}
+
+void Crossover::calculateAllpassCoefficients()
+{
+    const int mode = slope;
+    if (mode == 0)
+    {
+        // lopass - hipass = (w - s) / (w + s)
+        const double c = (w[0][1] - k[0][1]) / (w[0][1] + k[0][1]);
+        apA[0] = c;
+        apA[1] = 1.0;
+        apA[2] = 0.0;
+        apB[1] = c;
+        apB[2] = 0.0;
+    }
+    else
+    {
+        // lopass + hipass = (s^2 - sqrt(2)ws + w^2) / (s^2 + sqrt(2)ws + w^2)
+        const double d0 = k[0][2] + sqrt2 * w[0][1] * k[0][1] + w[0][2];
+        const double d1 = 2.0 * w[0][2] - 2.0 * k[0][2];
+        const double d2 = k[0][2] - sqrt2 * w[0][1] * k[0][1] + w[0][2];
+        apA[0] = d2 / d0;
+        apA[1] = d1 / d0;
+        apA[2] = 1.0;
+        apB[1] = d1 / d0;
+        apB[2] = d2 / d0;
+    }
+}
+
+void Crossover::packCoefficients()
+{
+    const int mode = slope;
+    kernelOrder = mode == 0 ? 2 : 4;
+    kernelStages = mode == 2 ? 2 : 1;
+
+    // the 12 dB/8ve hipass is inverted so that it sums flat with the lopass
+    const double hipassPolarity = mode == 0 ? -1.0 : 1.0;
+
+    for (int tap{ 0 }; tap < 5; ++tap)
+    {
+        for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+        {
+            combineCoefficients.a[tap][channelNo] = a[0][tap];
+            combineCoefficients.b[tap][channelNo] = b[0][tap];
+            combineCoefficients.a[tap][channelNo + 2] = hipassPolarity * a[1][tap];
+            combineCoefficients.b[tap][channelNo + 2] = b[1][tap];
+
+            splitCoefficients.a[tap][channelNo] = a[0][tap];
+            splitCoefficients.b[tap][channelNo] = b[0][tap];
+            splitCoefficients.a[tap][channelNo + 2] = tap < 3 ? apA[tap] : 0.0;
+            splitCoefficients.b[tap][channelNo + 2] = tap < 3 ? apB[tap] : 0.0;
+        }
+    }
+
+    // the offline kernel runs the same filters as cascaded biquads
+    SectionCoefficients combineSections{}, splitSections{};
+    combineSections.numSections = splitSections.numSections = mode == 0 ? 1 : (mode == 1 ? 2 : 4);
+
+    auto setSection = [](SectionCoefficients& sections, int section, int lane,
+                         double a0, double a1, double a2, double b1, double b2)
+    {
+        sections.a[section][0][lane] = a0;
+        sections.a[section][1][lane] = a1;
+        sections.a[section][2][lane] = a2;
+        sections.b[section][0][lane] = 1.0;
+        sections.b[section][1][lane] = b1;
+        sections.b[section][2][lane] = b2;
+    };
+
+    for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+    {
+        if (mode == 0)
+        {
+            // the 12 dB/8ve filters are already biquads
+            setSection(combineSections, 0, channelNo, a[0][0], a[0][1], a[0][2], b[0][1], b[0][2]);
+            setSection(combineSections, 0, channelNo + 2, -a[1][0], -a[1][1], -a[1][2], b[1][1], b[1][2]);
+        }
+        else
+        {
+            // the 24 dB/8ve filters are two identical butterworth biquads, and the 48 dB/8ve filters four
+            for (int i{ 0 }; i < 2; ++i)
+            {
+                const double d0 = k[i][2] + sqrt2 * w[i][1] * k[i][1] + w[i][2];
+                const double b1 = (2.0 * w[i][2] - 2.0 * k[i][2]) / d0;
+                const double b2 = (k[i][2] - sqrt2 * w[i][1] * k[i][1] + w[i][2]) / d0;
+                const double a0 = (i == 0 ? w[i][2] : k[i][2]) / d0;
+                const double a1 = (i == 0 ? 2.0 : -2.0) * a0;
+
+                for (int section{ 0 }; section < combineSections.numSections; ++section)
+                    setSection(combineSections, section, channelNo + 2 * i, a0, a1, a0, b1, b2);
+            }
+        }
+
+        // the allpass is a single biquad, so any further sections pass straight through
+        for (int section{ 0 }; section < splitSections.numSections; ++section)
+        {
+            for (int tap{ 0 }; tap < 3; ++tap)
+            {
+                splitSections.a[section][tap][channelNo] = combineSections.a[section][tap][channelNo];
+                splitSections.b[section][tap][channelNo] = combineSections.b[section][tap][channelNo];
+            }
+
+            if (section == 0)
+                setSection(splitSections, 0, channelNo + 2, apA[0], apA[1], apA[2], apB[1], apB[2]);
+            else
+                setSection(splitSections, section, channelNo + 2, 1.0, 0.0, 0.0, 0.0, 0.0);
+        }
+    }
+
+    FilterKernels::prepareOffline(combineOffline, combineSections);
+    FilterKernels::prepareOffline(splitOffline, splitSections);
+}
@@ -0,0 +1,360 @@
+#pragma once
+
+#include "FilterKernels.h"
+#include <algorithm>
+
+enum class FilterType { lopass, hipass };
+
+/**
+* A caller's buffer seen as channels of samples, which are processed in place without being copied
+*/
+struct AudioSpan
+{
+    float* const* channels;
+    int numChannels;
+    int numSamples;
+};
+
+//==============================================================================
+/**
+* Crossover
+* The Linkwitz-Riley lopass and hipass filters: their coefficients, their memory, and the kernels that run them.
+* Nothing here depends on JUCE, so the same filters can be built into the plugin and into other programs.
+* Call prepare() with the sample rate, then setSlope() and setCutoffs() followed by update() whenever they change.
+* @author Ryan Logan
+*
+*/
+class Crossover
+{
+public:
+    // combine() and split() process this many samples at a time, which keeps every lane of a tile in L1
+    static constexpr int tileLength = 256;
+
+    /**
+    * Sets the sample rate, recalculates the coefficients and clears all memory
+    * @param sampleRate The sample rate of the audio to be processed
+    */
+    void prepare(double sampleRate);
+
+    /**
+    * Sets all filter memory to 0.0
+    */
+    void reset();
+
+    /**
+    * Takes effect on the next call to update()
+    * @param lopass The lopass cutoff in Hz
+    * @param hipass The hipass cutoff in Hz
+    */
+    void setCutoffs(double lopass, double hipass);
+
+    /**
+    * Takes effect on the next call to update()
+    * @param slopeIndex 0, 1 or 2 for the 12, 24 and 48 dB/8ve slopes. Other values are clamped to that range
+    */
+    void setSlope(int slopeIndex);
+
+    /**
+    * @return 0, 1 or 2 for the 12, 24 and 48 dB/8ve slopes
+    */
+    int getSlope() const { return slope; }
+
+    /**
+    * Calculates the coefficients of every lane of the kernel for the current sample rate, cutoffs and slope
+    */
+    void update();
+
+    /**
+    * Chooses the build of the kernel to use
+    * @param type The kernel to use, or automatic to pick the fastest one supported by this machine
+    */
+    void setKernel(KernelType type);
+
+    /**
+    * @return The build of the kernel in use
+    */
+    const FilterKernel& getKernel() const { return kernel; }
+
+    /**
+    * Switches between realtime and offline rendering. Offline, the block kernel is used wherever it is faster than
+    * the realtime kernel on this machine, or where the caller will split long blocks across threads, which only the
+    * block kernel can do. The two kernels have separate memory, so the filters restart when the kernel changes
+    * @param offline True when rendering offline
+    * @param splitAcrossThreads True if the caller will run the block kernel itself through getOfflineCoefficients()
+    */
+    void setOffline(bool offline, bool splitAcrossThreads = false);
+
+    /**
+    * @return True if rendering offline
+    */
+    bool isOffline() const { return offline; }
+
+    /**
+    * @return True if process() runs the block kernel, so getOfflineCoefficients() and getOfflineState() are in use
+    */
+    bool usesOfflineKernel() const { return offlineKernel; }
+
+    /**
+    * Checks whether the hipass can be derived from the allpass the two filters sum to,
+    * which is only possible when they share a cutoff on the 12 and 24 dB/8ve slopes
+    * @return True if split() will filter the hipass lanes with the allpass
+    */
+    bool isComplementary() const;
+
+    /**
+    * @return True if the memory of the last two lanes was last run with the allpass, by split()
+    */
+    bool usesSplitCoefficients() const { return stateUsesSplitCoefficients; }
+
+    /**
+    * Runs the kernel over every lane in place
+    * @param lanes Lopass left/right then hipass or allpass left/right
+    * @param numSamples The number of samples in each lane
+    * @param useSplitCoefficients True to filter the last two lanes with the allpass rather than the hipass
+    * @param sumPairs True to write the sum of both bands to the first two lanes, leaving the last two unchanged
+    */
+    void process(float* const* lanes, int numSamples, bool useSplitCoefficients, bool sumPairs);
+
+    /**
+    * Gives the block form of the filters and its memory to code that runs the offline kernel itself
+    * @param useSplitCoefficients True for the lanes used by split(), false for those used by combine()
+    * @return The block form of every lane
+    */
+    const OfflineCoefficients& getOfflineCoefficients(bool useSplitCoefficients) const;
+
+    /**
+    * @param useSplitCoefficients True if the memory will be run with the lanes used by split()
+    * @return The memory of the offline kernel
+    */
+    OfflineState& getOfflineState(bool useSplitCoefficients);
+
+    /**
+    * Sums the lopass of one buffer with the hipass of another. Missing channels are filtered as silence
+    * @param lopass Up to two channels, which receive the sum
+    * @param hipass Up to two channels with at least as many samples as the lopass, which are left unchanged
+    */
+    void combine(AudioSpan lopass, AudioSpan hipass);
+
+    /**
+    * Splits a buffer into a lopass band, written over the input, and a hipass band
+    * @param input Up to two channels, which receive the lopass band
+    * @param hipass Up to two channels with at least as many samples as the input, which receive the hipass band
+    */
+    void split(AudioSpan input, AudioSpan hipass);
+
+    /**
+    * Walks two buffers a tile at a time the way combine() does, for callers that run their own filters on each tile
+    * @param lopass Up to two channels for the first two lanes
+    * @param hipass Up to two channels for the last two lanes, with at least as many samples as the lopass
+    * @param scratch kernelLanes channels of at least maxTileLength samples, which stand in for missing channels
+    * @param maxTileLength The most samples to filter at a time
+    * @param filter Called as filter(lanes, numSamples) for each tile, and must write the sum to the first two lanes
+    */
+    template <typename Filter>
+    static void combineTiles(AudioSpan lopass, AudioSpan hipass, AudioSpan scratch, int maxTileLength, Filter&& filter);
+
+    /**
+    * Walks a buffer a tile at a time the way split() does, for callers that run their own filters on each tile
+    * @param input Up to two channels, which receive the lopass band
+    * @param hipass Up to two channels with at least as many samples as the input, which receive the hipass band
+    * @param scratch kernelLanes channels of at least maxTileLength samples, which stand in for missing channels
+    * @param maxTileLength The most samples to filter at a time
+    * @param complementary True if the filter writes the allpass to the last two lanes, so the lopass is subtracted from it
+    * @param filter Called as filter(lanes, numSamples) for each tile, with a copy of the input in every lane
+    */
+    template <typename Filter>
+    static void splitTiles(AudioSpan input, AudioSpan hipass, AudioSpan scratch, int maxTileLength, bool complementary, Filter&& filter);
+
+private:
+    double sampleRate{ 44100.0 };
+
+    // centre frequency for lo-pass and hi-pass respectively
+    double fc[2]{ 750.0, 750.0 };
+
+    // 0, 1 or 2 for the 12, 24 and 48 dB/8ve slopes
+    int slope{ 1 };
+
+    // intermediate paramters for filters
+    // rows are left and right
+    // columns are used differently based on filter chosen
+    double w[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+    double k[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+
+    // filter coefficients
+    // second row is only for the second stage of cascaded filters
+    double a[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+    double b[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+
+    // allpass sum of the lopass and hipass when splitting at a single frequency
+    double apA[3]{ 0.0,0.0,0.0 };
+    double apB[3]{ 0.0,0.0,0.0 };
+
+    // the build of the filter kernel used for this machine
+    FilterKernel kernel{ FilterKernels::select() };
+
+    // coefficients for each lane of the kernel
+    // lopass left/right then either hipass left/right, or the allpass left/right when splitting
+    KernelCoefficients combineCoefficients{}, splitCoefficients{};
+
+    // memory for each lane of the kernel
+    KernelState kernelState{};
+
+    // which coefficients the last two lanes of memory were filtered with
+    bool stateUsesSplitCoefficients{ false };
+
+    // the block form of the same lanes, used when rendering offline
+    OfflineCoefficients combineOffline{}, splitOffline{};
+    OfflineState offlineState{};
+    bool offline{ false }, splitAcrossThreads{ false }, offlineKernel{ false };
+
+    // order and number of cascaded stages for the current slope
+    int kernelOrder{ 4 }, kernelStages{ 1 };
+
+    // stands in for missing channels in combine() and split()
+    float scratch[kernelLanes][tileLength]{};
+
+    // misc internal filter parameters
+    double tmp1{ 0.0 }, tmp2{ 0.0 }, tmp_a{ 0.0 };
+
+    /**
+    * Helper function that calculates all intermediary parameters for a filter
+    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
+    * @see prepHelper2()
+    * @see prepHelper4()
+    * @see prepHelper8()
+    */
+    void prepHelper(FilterType type);
+
+    /**
+    * Helper function that calculates all intermediary parameters for a filter
+    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
+    */
+    void prepHelper2(FilterType type);
+
+    /**
+    * Helper function that calculates all intermediary parameters for a filter
+    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
+    */
+    void prepHelper4(FilterType type);
+
+    /**
+    * Helper function that calculates all intermediary parameters for a filter
+    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
+    * @see prepHelper4()
+    */
+    void prepHelper8(FilterType type);
+
+    /**
+    * Helper function to calculate the filter coefficients
+    * @param type Chooses whether to update the lopass or hipass filter
+    * @see calculateCoefficients2()
+    * @see calculateCoefficients4()
+    * @see calculateCoefficients8()
+    */
+    void calculateCoefficients(FilterType type);
+
+    /**
+    * Helper function to calculate the filter coefficients
+    * @param type Chooses whether to update the lopass or hipass filter
+    */
+    void calculateCoefficients2(FilterType type);
+
+    /**
+    * Helper function to calculate the filter coefficients
+    * @param type Chooses whether to update the lopass or hipass filter
+    */
+    void calculateCoefficients4(FilterType type);
+
+    /**
+    * Helper function to calculate the filter coefficients
+    * @param type Chooses whether to update the lopass or hipass filter
+    * @see calculateCoefficients4()
+    */
+    void calculateCoefficients8(FilterType type);
+
+    /**
+    * Calculates the allpass that the lopass and hipass sum to. Only defined for the 12 and 24 dB/8ve slopes.
+    * Must be called after prepHelper() for the lopass.
+    */
+    void calculateAllpassCoefficients();
+
+    /**
+    * Copies the lopass, hipass and allpass coefficients into the lanes of the kernel,
+    * and builds the block form of each lane for the offline kernel
+    * @see update()
+    */
+    void packCoefficients();
+
+    /**
+    * Decides whether process() runs the block kernel, and clears the memory if that changes
+    * @see setOffline()
+    */
+    void chooseKernel();
+
+    /**
+    * Clears the memory of the last two lanes if they were last filtered with the other set of coefficients,
+    * since hipass memory is meaningless to the allpass and vice versa. The lopass lanes are the same in both sets
+    * @param useSplitCoefficients True if the lanes are about to be filtered with the coefficients used by split()
+    */
+    void matchStateTo(bool useSplitCoefficients);
+
+    /**
+    * Points each lane at a tile of the caller's channels, or at silence where a channel is missing
+    * @param lanes Receives the lopass left/right then hipass left/right lanes
+    * @param lopass The channels for the first two lanes
+    * @param hipass The channels for the last two lanes
+    * @param scratch The channels that stand in for missing ones, which are cleared
+    * @param startSample The first sample of the tile
+    * @param numSamples The number of samples in the tile
+    */
+    static void getTileLanes(float* (&lanes)[kernelLanes], AudioSpan lopass, AudioSpan hipass, AudioSpan scratch,
+                             int startSample, int numSamples);
+
+    /**
+    * @param lanes Receives a pointer to each lane of the scratch tile
+    * @return The scratch tile, for combineTiles() and splitTiles()
+    */
+    AudioSpan getScratch(float* (&lanes)[kernelLanes]);
+};
+
+//==============================================================================
+template <typename Filter>
+void Crossover::combineTiles(AudioSpan lopass, AudioSpan hipass, AudioSpan scratch, int maxTileLength, Filter&& filter)
+{
+    // walk the buffer a tile at a time, reading both inputs and writing the sum once
+    for (int startSample{ 0 }; maxTileLength > 0 && startSample < lopass.numSamples; startSample += maxTileLength)
+    {
+        const int numSamples = std::min(maxTileLength, lopass.numSamples - startSample);
+
+        float* lanes[kernelLanes];
+        getTileLanes(lanes, lopass, hipass, scratch, startSample, numSamples);
+        filter(lanes, numSamples);
+    }
+}
+
+template <typename Filter>
+void Crossover::splitTiles(AudioSpan input, AudioSpan hipass, AudioSpan scratch, int maxTileLength, bool complementary, Filter&& filter)
+{
+    const int numSplitChannels = std::min({ input.numChannels, hipass.numChannels, 2 });
+
+    // the copy, filter and subtract of each tile all stay in cache
+    for (int startSample{ 0 }; maxTileLength > 0 && startSample < input.numSamples; startSample += maxTileLength)
+    {
+        const int numSamples = std::min(maxTileLength, input.numSamples - startSample);
+
+        // the input may share its channels with the lopass output, so copy it to the hipass first
+        for (int channelNo{ 0 }; channelNo < numSplitChannels; ++channelNo)
+            std::copy(input.channels[channelNo] + startSample, input.channels[channelNo] + startSample + numSamples,
+                      hipass.channels[channelNo] + startSample);
+
+        float* lanes[kernelLanes];
+        getTileLanes(lanes, input, hipass, scratch, startSample, numSamples);
+        filter(lanes, numSamples);
+
+        // hipass = allpass - lopass
+        if (complementary)
+            for (int channelNo{ 0 }; channelNo < numSplitChannels; ++channelNo)
+                for (int sampleNo{ 0 }; sampleNo < numSamples; ++sampleNo)
+                    lanes[channelNo + 2][sampleNo] -= lanes[channelNo][sampleNo];
+    }
+}
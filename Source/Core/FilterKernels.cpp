@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    The generic build of the filter kernel, and the selection of the fastest
+    build for the machine the plugin is running on.
+
+    Like the rest of the core, this file must not depend on JUCE.
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if COMBINER_KERNEL_X86 && defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+namespace FilterKernels
+{
+    // CPU features the kernels need, including whether the OS saves the wider registers
+    struct Features
+    {
+        bool sse2{ false }, avx2{ false }, avx512{ false };
+    };
+
+    static Features detectFeatures()
+    {
+        Features features;
+       #if COMBINER_KERNEL_X86 && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        features.sse2 = (info[3] & (1 << 26)) != 0;
+
+        __cpuidex(info, 7, 0);
+        features.avx2 = (info[1] & (1 << 5)) != 0 && fma && (xcr0 & 0x06) == 0x06;
+        features.avx512 = (info[1] & (1 << 16)) != 0 && fma && (xcr0 & 0xe6) == 0xe6;
+       #elif COMBINER_KERNEL_X86
+        __builtin_cpu_init();
+        features.sse2 = __builtin_cpu_supports("sse2");
+        features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        features.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma");
+       #endif
+        return features;
+    }
+
+    // cpuid can be slow, particularly in a virtual machine, so every instance shares one detection
+    static const Features& getFeatures()
+    {
+        static const Features features = detectFeatures();
+        return features;
+    }
+
+    namespace generic
+    {
+        #include "FilterKernelsImpl.h"
+    }
+
+    static FilterKernel getKernel(KernelType type)
+    {
+        switch (type)
+        {
+        case KernelType::generic:
+            return { KernelType::generic, generic::process, generic::processOffline };
+        case KernelType::sse2:
+            return getSSE2Kernel();
+        case KernelType::avx2:
+            return getAVX2Kernel();
+        case KernelType::avx512:
+            return getAVX512Kernel();
+        case KernelType::neon:
+            return getNEONKernel();
+        default:
+            return { type, nullptr, nullptr };
+        }
+    }
+
+    bool isSupported(KernelType type)
+    {
+        if (getKernel(type).process == nullptr)
+            return false;
+
+        switch (type)
+        {
+        case KernelType::generic:
+            return true;
+        case KernelType::sse2:
+            return getFeatures().sse2;
+        case KernelType::avx2:
+            return getFeatures().avx2;
+        case KernelType::avx512:
+            return getFeatures().avx512;
+        case KernelType::neon:
+            // every CPU the NEON build is compiled for has NEON
+            return COMBINER_KERNEL_ARM != 0;
+        default:
+            return false;
+        }
+    }
+
+    const char* getName(KernelType type)
+    {
+        switch (type)
+        {
+        case KernelType::generic:
+            return "generic";
+        case KernelType::sse2:
+            return "sse2";
+        case KernelType::avx2:
+            return "avx2";
+        case KernelType::avx512:
+            return "avx512";
+        case KernelType::neon:
+            return "neon";
+        default:
+            return "automatic";
+        }
+    }
+
+    FilterKernel select(KernelType preferred)
+    {
+        // allow the kernel to be forced from outside the host for testing
+        if (preferred == KernelType::automatic)
+        {
+           #if defined(_MSC_VER)
+            #pragma warning(suppress: 4996)
+           #endif
+            const char* name = std::getenv("COMBINER_KERNEL");
+            for (auto type : { KernelType::generic, KernelType::sse2, KernelType::avx2, KernelType::avx512, KernelType::neon })
+                if (name != nullptr && std::strcmp(name, getName(type)) == 0)
+                    preferred = type;
+        }
+
+        if (preferred != KernelType::automatic && isSupported(preferred))
+            return getKernel(preferred);
+
+        // otherwise take the fastest instruction set available. The four lanes fill an AVX2 vector exactly,
+        // and the AVX-512 build measures slower than AVX2 at 24 and 48 dB/8ve, so it is only a fallback (see Tools/KernelBench)
+        for (auto type : { KernelType::avx2, KernelType::avx512, KernelType::neon, KernelType::sse2 })
+            if (isSupported(type))
+                return getKernel(type);
+
+        return getKernel(KernelType::generic);
+    }
+
+    bool isOfflineFaster(KernelType type, int order, int numStages)
+    {
+        // measured with Tools/KernelBench; the block kernel is only used where it won clearly on every run, and the
+        // NEON kernel has not been measured. Fixed so that an offline render never depends on the machine's load.
+        //                                         12 dB  24 dB  48 dB
+        static constexpr bool blockIsFaster[][3] { { false, false, false },   // automatic
+                                                   { false, true,  false },   // generic
+                                                   { false, true,  false },   // sse2
+                                                   { true,  false, false },   // avx2
+                                                   { false, false, true  },   // avx512
+                                                   { false, false, false } }; // neon
+
+        return blockIsFaster[static_cast<int>(type)][order == 2 ? 0 : (numStages == 1 ? 1 : 2)];
+    }
+
+    void prepareOffline(OfflineCoefficients& offline, const SectionCoefficients& sections)
+    {
+        offline = {};
+        offline.sections = sections;
+
+        for (int lane = 0; lane < kernelLanes; ++lane)
+        {
+            for (int section = 0; section < sections.numSections; ++section)
+            {
+                const double a0 = sections.a[section][0][lane], a1 = sections.a[section][1][lane], a2 = sections.a[section][2][lane];
+                const double b1 = sections.b[section][1][lane], b2 = sections.b[section][2][lane];
+
+                // runs the biquad over a block, starting from the given memory and inputs
+                auto respond = [=](double x1, double x2, double y1, double y2,
+                                   const double (&inputs)[offlineBlockLength], double (&outputs)[offlineBlockLength])
+                {
+                    for (int i = 0; i < offlineBlockLength; ++i)
+                    {
+                        const double output = a0 * inputs[i] + a1 * x1 + a2 * x2 - b1 * y1 - b2 * y2;
+                        x2 = x1;
+                        x1 = inputs[i];
+                        y2 = y1;
+                        y1 = output;
+                        outputs[i] = output;
+                    }
+                };
+
+                const double silence[offlineBlockLength]{};
+                double outputs[offlineBlockLength];
+
+                // the response of the block to each tap of memory on its own
+                respond(1.0, 0.0, 0.0, 0.0, silence, outputs);
+                for (int i = 0; i < offlineBlockLength; ++i)
+                    offline.fromInputs[section][1][i][lane] = outputs[i];
+                respond(0.0, 1.0, 0.0, 0.0, silence, outputs);
+                for (int i = 0; i < offlineBlockLength; ++i)
+                    offline.fromInputs[section][2][i][lane] = outputs[i];
+                respond(0.0, 0.0, 1.0, 0.0, silence, outputs);
+                for (int i = 0; i < offlineBlockLength; ++i)
+                    offline.fromOutputs[section][1][i][lane] = outputs[i];
+                respond(0.0, 0.0, 0.0, 1.0, silence, outputs);
+                for (int i = 0; i < offlineBlockLength; ++i)
+                    offline.fromOutputs[section][2][i][lane] = outputs[i];
+
+                // the impulse response, shifted along for each input in the block
+                const double impulse[offlineBlockLength]{ 1.0 };
+                respond(0.0, 0.0, 0.0, 0.0, impulse, outputs);
+                for (int j = 0; j < offlineBlockLength; ++j)
+                    for (int i = j; i < offlineBlockLength; ++i)
+                        offline.impulse[section][j][i][lane] = outputs[i - j];
+            }
+        }
+    }
+}
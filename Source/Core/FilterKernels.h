@@ -0,0 +1,180 @@
+#pragma once
+
+// Instruction set families the kernels can be built for
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define COMBINER_KERNEL_X86 1
+#else
+ #define COMBINER_KERNEL_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+ #define COMBINER_KERNEL_ARM 1
+#else
+ #define COMBINER_KERNEL_ARM 0
+#endif
+
+// Number of filters run side by side: lopass left/right then hipass left/right.
+// All four lanes share vectors in the kernel, so one band costs as much as two. Filtering a band on its own, caching
+// an unchanged band, or running the lopass at a decimated rate for low cutoffs would therefore save no work, and a
+// cache or a polyphase decimator and interpolator would cost more per sample than the filters.
+// Nor are the lanes of several plugin instances batched into one kernel: each instance must return its output before
+// the host processes the next, so batching would add a block of latency. Its only gain would be filling the wider
+// vectors of the AVX-512 build, which FilterKernels::select() passes over because it measures slower than the AVX2
+// build, whose vectors four lanes already fill (see Tools/KernelBench).
+constexpr int kernelLanes = 4;
+
+// Number of consecutive samples the offline kernel computes together
+constexpr int offlineBlockLength = 8;
+
+// Most biquads cascaded in one lane: the 48 dB/8ve slope
+constexpr int maxSections = 4;
+
+//==============================================================================
+/**
+* Filter coefficients for every lane of a kernel.
+* Taps beyond the order of the filter are ignored.
+*/
+struct KernelCoefficients
+{
+    // indexed [tap][lane]
+    alignas(64) double a[5][kernelLanes];
+    alignas(64) double b[5][kernelLanes];
+};
+
+/**
+* Memory for every lane of a kernel, for up to two cascaded stages
+*/
+struct KernelState
+{
+    // indexed [stage][tap][lane]
+    alignas(64) double x[2][5][kernelLanes];
+    alignas(64) double y[2][5][kernelLanes];
+};
+
+/**
+* The filters of every lane factored into cascaded biquads.
+* Unlike the fourth order direct form, biquads stay accurate at low cutoffs when rearranged for the offline kernel.
+* Unused sections of a lane must pass the signal straight through.
+*/
+struct SectionCoefficients
+{
+    // indexed [section][tap][lane]
+    double a[maxSections][3][kernelLanes];
+    double b[maxSections][3][kernelLanes];
+    int numSections;
+};
+
+/**
+* Each biquad of every lane rewritten as a recurrence over blocks of offlineBlockLength samples:
+*   outputs = fromInputs * x + fromOutputs * y + impulse * inputs
+* where x and y are the memory of the biquad at the start of the block. Every output in a block
+* depends only on that memory and the inputs to the block, so the outputs no longer wait on each other
+* one sample at a time, and the memory for the next block is simply the last inputs and outputs.
+*/
+struct OfflineCoefficients
+{
+    // indexed [section][tap][sample in block][lane]
+    alignas(64) double fromInputs[maxSections][3][offlineBlockLength][kernelLanes];
+    alignas(64) double fromOutputs[maxSections][3][offlineBlockLength][kernelLanes];
+    // indexed [section][input in block][output in block][lane]
+    alignas(64) double impulse[maxSections][offlineBlockLength][offlineBlockLength][kernelLanes];
+
+    // the biquads themselves, used for samples left over after the last whole block
+    SectionCoefficients sections;
+};
+
+/**
+* Memory for every biquad of every lane of the offline kernel
+*/
+struct OfflineState
+{
+    // indexed [section][tap][lane]
+    double x[maxSections][3][kernelLanes];
+    double y[maxSections][3][kernelLanes];
+};
+
+/**
+* Filters every lane in place
+* @param coefficients The coefficients of each lane
+* @param state The memory of each lane
+* @param lanes One pointer per lane to the samples to be processed
+* @param numSamples The number of samples in each lane
+* @param order The order of each stage, 2 or 4
+* @param numStages The number of identical stages to cascade, 1 or 2
+* @param sumPairs If true the first two lanes receive the sum of the first and last pairs of filtered lanes,
+*                 and the last two lanes are left as they were, so each output sample is written once
+*/
+using KernelFunction = void (*)(const KernelCoefficients& coefficients, KernelState& state,
+                                float* const* lanes, int numSamples, int order, int numStages, bool sumPairs);
+
+/**
+* Filters every lane in place, offlineBlockLength samples at a time
+* @param coefficients The block form of each lane
+* @param state The memory of each biquad of each lane
+* @param lanes One pointer per lane to the samples to be processed
+* @param numSamples The number of samples in each lane
+* @param sumPairs If true the first two lanes receive the sum of the first and last pairs of filtered lanes
+*/
+using OfflineKernelFunction = void (*)(const OfflineCoefficients& coefficients, OfflineState& state,
+                                       float* const* lanes, int numSamples, bool sumPairs);
+
+// The instruction sets the kernel is compiled for
+enum class KernelType { automatic, generic, sse2, avx2, avx512, neon };
+
+/**
+* A build of the kernel together with the instruction set it was compiled for
+*/
+struct FilterKernel
+{
+    KernelType type;
+    KernelFunction process;
+    OfflineKernelFunction processOffline;
+};
+
+namespace FilterKernels
+{
+    /**
+    * Chooses the kernel to use on this machine, preferring AVX2 over AVX-512
+    * @param preferred A kernel to use instead of the fastest one, if this machine supports it.
+    *                  When automatic, the COMBINER_KERNEL environment variable may name one instead.
+    * @return The preferred kernel if it is supported, otherwise the fastest supported kernel
+    */
+    FilterKernel select(KernelType preferred = KernelType::automatic);
+
+    /**
+    * Checks whether a kernel was built into this binary and can run on this machine
+    * @param type The kernel to check
+    * @return True if the kernel can be used
+    */
+    bool isSupported(KernelType type);
+
+    /**
+    * @param type The kernel to name
+    * @return A short lower case name for the kernel, e.g. "avx2"
+    */
+    const char* getName(KernelType type);
+
+    /**
+    * Builds the block form of every lane used by the offline kernel
+    * @param offline Receives the block form
+    * @param sections The biquads of each lane
+    */
+    void prepareOffline(OfflineCoefficients& offline, const SectionCoefficients& sections);
+
+    /**
+    * Looks up whether the offline kernel is faster than the realtime kernel for a build and slope. The answers were
+    * measured with Tools/KernelBench and are fixed, so every offline render of a session makes the same choice.
+    * @param type The build of the kernel
+    * @param order The order of each stage of the realtime form, 2 or 4
+    * @param numStages The number of stages of the realtime form, 1 or 2
+    * @return True if the offline kernel should be used when rendering offline
+    */
+    bool isOfflineFaster(KernelType type, int order, int numStages);
+
+    // Per instruction set builds, defined in FilterKernels<ISA>.cpp
+    // Each returns a kernel with null functions if the file was not compiled for a matching CPU family
+    FilterKernel getSSE2Kernel();
+    FilterKernel getAVX2Kernel();
+    FilterKernel getAVX512Kernel();
+    FilterKernel getNEONKernel();
+}
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    The filter kernel built for AVX2 and FMA.
+
+    MSVC builds this file with the "avx2" compiler flag scheme (/arch:AVX2).
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+
+#if COMBINER_KERNEL_X86
+
+namespace FilterKernels
+{
+   #if defined(__clang__)
+    #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+   #elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx2,fma")
+   #endif
+
+    namespace avx2
+    {
+        #include "FilterKernelsImpl.h"
+    }
+
+   #if defined(__clang__)
+    #pragma clang attribute pop
+   #elif defined(__GNUC__)
+    #pragma GCC pop_options
+   #endif
+
+    FilterKernel getAVX2Kernel()
+    {
+        return { KernelType::avx2, avx2::process, avx2::processOffline };
+    }
+}
+
+#else
+
+namespace FilterKernels
+{
+    FilterKernel getAVX2Kernel()
+    {
+        return { KernelType::avx2, nullptr, nullptr };
+    }
+}
+
+#endif
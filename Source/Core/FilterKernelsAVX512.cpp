@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    The filter kernel built for AVX-512F.
+
+    MSVC builds this file with the "avx512" compiler flag scheme (/arch:AVX512).
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+
+#if COMBINER_KERNEL_X86
+
+namespace FilterKernels
+{
+   #if defined(__clang__)
+    #pragma clang attribute push (__attribute__((target("avx512f,fma"))), apply_to = function)
+   #elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx512f,fma")
+   #endif
+
+    namespace avx512
+    {
+        #include "FilterKernelsImpl.h"
+    }
+
+   #if defined(__clang__)
+    #pragma clang attribute pop
+   #elif defined(__GNUC__)
+    #pragma GCC pop_options
+   #endif
+
+    FilterKernel getAVX512Kernel()
+    {
+        return { KernelType::avx512, avx512::process, avx512::processOffline };
+    }
+}
+
+#else
+
+namespace FilterKernels
+{
+    FilterKernel getAVX512Kernel()
+    {
+        return { KernelType::avx512, nullptr, nullptr };
+    }
+}
+
+#endif
@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+    The body of the filter kernel.
+
+    This file is included by each of the FilterKernels*.cpp files inside a
+    namespace named after the instruction set that file is compiled for.
+    It must not include any other headers: inline functions pulled in from a
+    shared header could be merged with a build for a wider instruction set
+    by the linker, and then crash on older machines.
+
+  ==============================================================================
+*/
+
+/**
+* Applies cascaded direct form filters to every lane. Each lane is computed independently,
+* so the inner loops over the lanes are what the compiler vectorises.
+*/
+template <int order, int numStages, bool sumPairs>
+static void processLanes(const KernelCoefficients& coefficients, KernelState& state, float* const* lanes, int numSamples)
+{
+    // copy the memory to locals so it can be kept in registers
+    double x[numStages][order + 1][kernelLanes];
+    double y[numStages][order + 1][kernelLanes];
+    for (int stage = 0; stage < numStages; ++stage)
+        for (int tap = 1; tap <= order; ++tap)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                x[stage][tap][lane] = state.x[stage][tap][lane];
+                y[stage][tap][lane] = state.y[stage][tap][lane];
+            }
+
+    for (int sampleNo = 0; sampleNo < numSamples; ++sampleNo)
+    {
+        double input[kernelLanes];
+        for (int lane = 0; lane < kernelLanes; ++lane)
+            input[lane] = lanes[lane][sampleNo];
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            //Apply transfer function
+            double output[kernelLanes];
+            for (int lane = 0; lane < kernelLanes; ++lane)
+                output[lane] = coefficients.a[0][lane] * input[lane];
+
+            for (int tap = 1; tap <= order; ++tap)
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                    output[lane] += coefficients.a[tap][lane] * x[stage][tap][lane]
+                                  - coefficients.b[tap][lane] * y[stage][tap][lane];
+
+            //propogate memory
+            for (int tap = order; tap > 1; --tap)
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                {
+                    x[stage][tap][lane] = x[stage][tap - 1][lane];
+                    y[stage][tap][lane] = y[stage][tap - 1][lane];
+                }
+
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                x[stage][1][lane] = input[lane];
+                y[stage][1][lane] = output[lane];
+                input[lane] = output[lane];
+            }
+        }
+
+        if (sumPairs)
+        {
+            lanes[0][sampleNo] = static_cast<float>(input[0] + input[2]);
+            lanes[1][sampleNo] = static_cast<float>(input[1] + input[3]);
+        }
+        else
+        {
+            for (int lane = 0; lane < kernelLanes; ++lane)
+                lanes[lane][sampleNo] = static_cast<float>(input[lane]);
+        }
+    }
+
+    for (int stage = 0; stage < numStages; ++stage)
+        for (int tap = 1; tap <= order; ++tap)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                state.x[stage][tap][lane] = x[stage][tap][lane];
+                state.y[stage][tap][lane] = y[stage][tap][lane];
+            }
+}
+
+template <bool sumPairs>
+static void processOrder(const KernelCoefficients& coefficients, KernelState& state, float* const* lanes, int numSamples, int order, int numStages)
+{
+    if (order == 2)
+        processLanes<2, 1, sumPairs>(coefficients, state, lanes, numSamples);
+    else if (numStages == 2)
+        processLanes<4, 2, sumPairs>(coefficients, state, lanes, numSamples);
+    else
+        processLanes<4, 1, sumPairs>(coefficients, state, lanes, numSamples);
+}
+
+static void process(const KernelCoefficients& coefficients, KernelState& state, float* const* lanes, int numSamples,
+                    int order, int numStages, bool sumPairs)
+{
+    if (sumPairs)
+        processOrder<true>(coefficients, state, lanes, numSamples, order, numStages);
+    else
+        processOrder<false>(coefficients, state, lanes, numSamples, order, numStages);
+}
+
+/**
+* Applies cascaded biquads to every lane, offlineBlockLength samples at a time.
+* The outputs of a block are independent of each other, and the inner loops over the lanes
+* are what the compiler vectorises.
+*/
+template <int numSections, bool sumPairs>
+static void processBlocks(const OfflineCoefficients& coefficients, OfflineState& state, float* const* lanes, int numSamples)
+{
+    // copy the memory to locals so it can be kept in registers
+    double x[numSections][3][kernelLanes];
+    double y[numSections][3][kernelLanes];
+    for (int section = 0; section < numSections; ++section)
+        for (int tap = 1; tap < 3; ++tap)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                x[section][tap][lane] = state.x[section][tap][lane];
+                y[section][tap][lane] = state.y[section][tap][lane];
+            }
+
+    int sampleNo = 0;
+    for (; sampleNo + offlineBlockLength <= numSamples; sampleNo += offlineBlockLength)
+    {
+        double input[offlineBlockLength][kernelLanes];
+        for (int i = 0; i < offlineBlockLength; ++i)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+                input[i][lane] = lanes[lane][sampleNo + i];
+
+        for (int section = 0; section < numSections; ++section)
+        {
+            double output[offlineBlockLength][kernelLanes];
+            for (int i = 0; i < offlineBlockLength; ++i)
+            {
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                    output[i][lane] = coefficients.fromInputs[section][1][i][lane] * x[section][1][lane]
+                                    + coefficients.fromInputs[section][2][i][lane] * x[section][2][lane]
+                                    + coefficients.fromOutputs[section][1][i][lane] * y[section][1][lane]
+                                    + coefficients.fromOutputs[section][2][i][lane] * y[section][2][lane];
+
+                // only earlier inputs in the block reach each output
+                for (int j = 0; j <= i; ++j)
+                    for (int lane = 0; lane < kernelLanes; ++lane)
+                        output[i][lane] += coefficients.impulse[section][j][i][lane] * input[j][lane];
+            }
+
+            // the memory for the next block is the end of this one
+            for (int tap = 1; tap < 3; ++tap)
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                {
+                    x[section][tap][lane] = input[offlineBlockLength - tap][lane];
+                    y[section][tap][lane] = output[offlineBlockLength - tap][lane];
+                }
+
+            for (int i = 0; i < offlineBlockLength; ++i)
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                    input[i][lane] = output[i][lane];
+        }
+
+        if (sumPairs)
+        {
+            for (int i = 0; i < offlineBlockLength; ++i)
+            {
+                lanes[0][sampleNo + i] = static_cast<float>(input[i][0] + input[i][2]);
+                lanes[1][sampleNo + i] = static_cast<float>(input[i][1] + input[i][3]);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < offlineBlockLength; ++i)
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                    lanes[lane][sampleNo + i] = static_cast<float>(input[i][lane]);
+        }
+    }
+
+    // the samples left over at the end are processed one at a time
+    const auto& sections = coefficients.sections;
+    for (; sampleNo < numSamples; ++sampleNo)
+    {
+        double input[kernelLanes];
+        for (int lane = 0; lane < kernelLanes; ++lane)
+            input[lane] = lanes[lane][sampleNo];
+
+        for (int section = 0; section < numSections; ++section)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                const double output = sections.a[section][0][lane] * input[lane]
+                    + sections.a[section][1][lane] * x[section][1][lane]
+                    + sections.a[section][2][lane] * x[section][2][lane]
+                    - sections.b[section][1][lane] * y[section][1][lane]
+                    - sections.b[section][2][lane] * y[section][2][lane];
+
+                x[section][2][lane] = x[section][1][lane];
+                x[section][1][lane] = input[lane];
+                y[section][2][lane] = y[section][1][lane];
+                y[section][1][lane] = output;
+                input[lane] = output;
+            }
+
+        if (sumPairs)
+        {
+            lanes[0][sampleNo] = static_cast<float>(input[0] + input[2]);
+            lanes[1][sampleNo] = static_cast<float>(input[1] + input[3]);
+        }
+        else
+        {
+            for (int lane = 0; lane < kernelLanes; ++lane)
+                lanes[lane][sampleNo] = static_cast<float>(input[lane]);
+        }
+    }
+
+    for (int section = 0; section < numSections; ++section)
+        for (int tap = 1; tap < 3; ++tap)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                state.x[section][tap][lane] = x[section][tap][lane];
+                state.y[section][tap][lane] = y[section][tap][lane];
+            }
+}
+
+template <bool sumPairs>
+static void processSections(const OfflineCoefficients& coefficients, OfflineState& state, float* const* lanes, int numSamples)
+{
+    if (coefficients.sections.numSections == 1)
+        processBlocks<1, sumPairs>(coefficients, state, lanes, numSamples);
+    else if (coefficients.sections.numSections == 2)
+        processBlocks<2, sumPairs>(coefficients, state, lanes, numSamples);
+    else
+        processBlocks<maxSections, sumPairs>(coefficients, state, lanes, numSamples);
+}
+
+static void processOffline(const OfflineCoefficients& coefficients, OfflineState& state, float* const* lanes, int numSamples, bool sumPairs)
+{
+    if (sumPairs)
+        processSections<true>(coefficients, state, lanes, numSamples);
+    else
+        processSections<false>(coefficients, state, lanes, numSamples);
+}
@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    The filter kernel built for NEON.
+
+    NEON is part of every ARMv8 CPU, so this file needs no extra compiler flags.
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+
+#if COMBINER_KERNEL_ARM
+
+namespace FilterKernels
+{
+    namespace neon
+    {
+        #include "FilterKernelsImpl.h"
+    }
+
+    FilterKernel getNEONKernel()
+    {
+        return { KernelType::neon, neon::process, neon::processOffline };
+    }
+}
+
+#else
+
+namespace FilterKernels
+{
+    FilterKernel getNEONKernel()
+    {
+        return { KernelType::neon, nullptr, nullptr };
+    }
+}
+
+#endif
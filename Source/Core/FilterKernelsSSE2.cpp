@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    The filter kernel built for SSE2.
+
+    SSE2 is part of every x86-64 CPU, so this file needs no extra compiler flags.
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+
+#if COMBINER_KERNEL_X86
+
+namespace FilterKernels
+{
+    namespace sse2
+    {
+        #include "FilterKernelsImpl.h"
+    }
+
+    FilterKernel getSSE2Kernel()
+    {
+        return { KernelType::sse2, sse2::process, sse2::processOffline };
+    }
+}
+
+#else
+
+namespace FilterKernels
+{
+    FilterKernel getSSE2Kernel()
+    {
+        return { KernelType::sse2, nullptr, nullptr };
+    }
+}
+
+#endif
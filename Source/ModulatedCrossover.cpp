@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    State variable filter crossover with per-sample cutoff modulation.
+
+  ==============================================================================
+*/
+
+#include "ModulatedCrossover.h"
+
+namespace
+{
+    // the bilinear transform maps nyquist to pi / 2, so stay just below it
+    constexpr double maxAngle = 1.5;
+
+    // time for a change of cutoff from the host or UI to take effect
+    constexpr double cutoffRampSeconds = 0.02;
+}
+
+double ModulatedCrossover::fastTan(double x)
+{
+    const double x2 = x * x;
+    return x * (945.0 - 105.0 * x2 + x2 * x2) / (945.0 - 420.0 * x2 + 15.0 * x2 * x2);
+}
+
+ModulatedCrossover::ModulatedCrossover()
+{
+    // the smoothing is multiplicative, so start from the default cutoff rather than 0 Hz
+    for (auto& cutoff : cutoffs)
+        cutoff.setCurrentAndTargetValue(750.0);
+}
+
+void ModulatedCrossover::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    for (auto& cutoff : cutoffs)
+        cutoff.reset(sampleRate, cutoffRampSeconds);
+    updateEnvelopeCoefficients();
+    reset();
+}
+
+void ModulatedCrossover::reset()
+{
+    for (int section{ 0 }; section < maxSections; ++section)
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+        {
+            ic1[section][lane] = 0.0;
+            ic2[section][lane] = 0.0;
+        }
+
+    for (auto& cutoff : cutoffs)
+        cutoff.setCurrentAndTargetValue(cutoff.getTargetValue());
+    envelope = 0.0;
+}
+
+void ModulatedCrossover::setSlope(int slopeIndex)
+{
+    const int newNumSections = slopeIndex == 0 ? 1 : (slopeIndex == 1 ? 2 : 4);
+    if (newNumSections == numSections)
+        return;
+
+    numSections = newNumSections;
+
+    // a critically damped section is the square of a first order butterworth filter
+    damping = slopeIndex == 0 ? 2.0 : juce::MathConstants<double>::sqrt2;
+
+    // the 12 dB/8ve hipass is inverted so that it sums flat with the lopass
+    hipassPolarity = slopeIndex == 0 ? -1.0 : 1.0;
+
+    reset();
+}
+
+void ModulatedCrossover::setCutoffs(double lopass, double hipass)
+{
+    cutoffs[0].setTargetValue(lopass);
+    cutoffs[1].setTargetValue(hipass);
+}
+
+void ModulatedCrossover::setEnvelope(double depthOctaves, double newAttackMs, double newReleaseMs)
+{
+    depth = depthOctaves;
+    if (newAttackMs != attackMs || newReleaseMs != releaseMs)
+    {
+        attackMs = newAttackMs;
+        releaseMs = newReleaseMs;
+        updateEnvelopeCoefficients();
+    }
+}
+
+void ModulatedCrossover::updateEnvelopeCoefficients()
+{
+    attack = 1.0 - std::exp(-1000.0 / (juce::jmax(attackMs, 0.01) * sampleRate));
+    release = 1.0 - std::exp(-1000.0 / (juce::jmax(releaseMs, 0.01) * sampleRate));
+}
+
+void ModulatedCrossover::process(float* const* lanes, int numSamples, bool sumPairs)
+{
+    const double angle = juce::MathConstants<double>::pi / sampleRate;
+
+    for (int sampleNo{ 0 }; sampleNo < numSamples; ++sampleNo)
+    {
+        double input[kernelLanes];
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+            input[lane] = lanes[lane][sampleNo];
+
+        // follow the peak level of the lopass input
+        const double detector = juce::jmax(std::abs(input[0]), std::abs(input[1]));
+        envelope += (detector > envelope ? attack : release) * (detector - envelope);
+        const double shift = depth == 0.0 ? 1.0 : std::exp2(depth * juce::jmin(envelope, 1.0));
+
+        // the cutoff only enters through g, so it can change every sample
+        double a1[kernelLanes], a2[kernelLanes], a3[kernelLanes];
+        for (int i{ 0 }; i < 2; ++i)
+        {
+            const double g = fastTan(juce::jmin(angle * cutoffs[i].getNextValue() * shift, maxAngle));
+            const double coefficient = 1.0 / (1.0 + g * (g + damping));
+            for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+            {
+                a1[2 * i + channelNo] = coefficient;
+                a2[2 * i + channelNo] = g * coefficient;
+                a3[2 * i + channelNo] = g * g * coefficient;
+            }
+        }
+
+        for (int section{ 0 }; section < numSections; ++section)
+        {
+            for (int lane{ 0 }; lane < kernelLanes; ++lane)
+            {
+                const double v3 = input[lane] - ic2[section][lane];
+                const double v1 = a1[lane] * ic1[section][lane] + a2[lane] * v3;
+                const double v2 = ic2[section][lane] + a2[lane] * ic1[section][lane] + a3[lane] * v3;
+                ic1[section][lane] = 2.0 * v1 - ic1[section][lane];
+                ic2[section][lane] = 2.0 * v2 - ic2[section][lane];
+
+                // lopass lanes take the lowpass output, hipass lanes the highpass output
+                input[lane] = lane < 2 ? v2 : input[lane] - damping * v1 - v2;
+            }
+        }
+
+        if (sumPairs)
+        {
+            lanes[0][sampleNo] = static_cast<float>(input[0] + hipassPolarity * input[2]);
+            lanes[1][sampleNo] = static_cast<float>(input[1] + hipassPolarity * input[3]);
+        }
+        else
+        {
+            lanes[0][sampleNo] = static_cast<float>(input[0]);
+            lanes[1][sampleNo] = static_cast<float>(input[1]);
+            lanes[2][sampleNo] = static_cast<float>(hipassPolarity * input[2]);
+            lanes[3][sampleNo] = static_cast<float>(hipassPolarity * input[3]);
+        }
+    }
+}
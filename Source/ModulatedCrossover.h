@@ -0,0 +1,90 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Core/FilterKernels.h"
+
+//==============================================================================
+/**
+* ModulatedCrossover
+* Produces the same Linkwitz-Riley responses as the kernel using topology-preserving
+* state variable filters. The cutoff only enters the filters through tan(), so it can
+* change every sample without recalculating any coefficients and without the filters
+* going unstable, which lets a built-in envelope follower sweep both cutoffs.
+* @author Ryan Logan
+*
+*/
+class ModulatedCrossover
+{
+public:
+    ModulatedCrossover();
+
+    /**
+    * Sets the sample rate and clears all memory
+    * @param sampleRate The sample rate passed to prepareToPlay()
+    */
+    void prepare(double sampleRate);
+
+    /**
+    * Sets all filter memory and the envelope to 0.0
+    */
+    void reset();
+
+    /**
+    * @param slopeIndex 0, 1 or 2 for the 12, 24 and 48 dB/8ve slopes
+    */
+    void setSlope(int slopeIndex);
+
+    /**
+    * Sets the cutoffs the envelope modulates around. Changes are smoothed over a few milliseconds
+    * @param lopass The lopass cutoff in Hz
+    * @param hipass The hipass cutoff in Hz
+    */
+    void setCutoffs(double lopass, double hipass);
+
+    /**
+    * Sets how the envelope of the lopass input moves both cutoffs
+    * @param depthOctaves How far a full scale envelope shifts the cutoffs, negative to move them down
+    * @param attackMs Time for the envelope to rise towards a louder input
+    * @param releaseMs Time for the envelope to fall towards a quieter input
+    */
+    void setEnvelope(double depthOctaves, double attackMs, double releaseMs);
+
+    /**
+    * Filters every lane in place
+    * @param lanes Lopass left/right then hipass left/right
+    * @param numSamples The number of samples in each lane
+    * @param sumPairs If true the lopass lanes receive the sum of both bands, and the hipass lanes are left as they were
+    */
+    void process(float* const* lanes, int numSamples, bool sumPairs);
+
+    /**
+    * A [5/4] Pade approximation of tan(x), within 2e-5 of it for x below 1.4
+    * @param x The angle, from 0 up to just below pi / 2
+    */
+    static double fastTan(double x);
+
+private:
+    double sampleRate{ 44100.0 };
+
+    // 12 dB/8ve is one critically damped section, 24 dB/8ve two butterworth sections and 48 dB/8ve four
+    int numSections{ 2 };
+    double damping{ juce::MathConstants<double>::sqrt2 };
+    double hipassPolarity{ 1.0 };
+
+    // the unmodulated lopass and hipass cutoffs
+    juce::SmoothedValue<double, juce::ValueSmoothingTypes::Multiplicative> cutoffs[2];
+
+    // envelope follower
+    double depth{ 0.0 }, attackMs{ 10.0 }, releaseMs{ 100.0 };
+    double attack{ 1.0 }, release{ 1.0 };
+    double envelope{ 0.0 };
+
+    // integrator memory, indexed [section][lane]
+    double ic1[maxSections][kernelLanes]{};
+    double ic2[maxSections][kernelLanes]{};
+
+    /**
+    * Converts the envelope times to per-sample coefficients for the current sample rate
+    */
+    void updateEnvelopeCoefficients();
+};
@@ -13,39 +13,33 @@
 CombinerAudioProcessorEditor::CombinerAudioProcessorEditor (CombinerAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
+    COMBINER_TRACE_SCOPE("editor.open")
+
+    // only this editor and its children use the colour scheme
+    setLookAndFeel(lookAndFeel);
     setResizable(true, true);
     setupLinkButton();
 
     // Create text elements
     title.setFont(juce::Font(30.0f, juce::Font::bold));
     title.setText("COMBINER", juce::dontSendNotification);
-    title.setColour(juce::Label::textColourId, POWDER_BLUE);
     title.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(title);
 
     lopassfilter.setFont(juce::Font(25.0f, juce::Font::bold));
     lopassfilter.setText("Low-Pass Filter", juce::dontSendNotification);
-    lopassfilter.setColour(juce::Label::textColourId, POWDER_BLUE);
     lopassfilter.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(lopassfilter);
 
     hipassfilter.setFont(juce::Font(25.0f, juce::Font::bold));
     hipassfilter.setText("High-Pass Filter", juce::dontSendNotification);
-    hipassfilter.setColour(juce::Label::textColourId, POWDER_BLUE);
     hipassfilter.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(hipassfilter);
 
-    // setup colour scheme
-    getLookAndFeel().setColour(juce::Slider::thumbColourId, HONEYDEW);
-    getLookAndFeel().setColour(juce::Slider::rotarySliderFillColourId, CALEDON_BLUE);
-    getLookAndFeel().setColour(juce::Slider::rotarySliderOutlineColourId, POWDER_BLUE);
-    getLookAndFeel().setColour(juce::Slider::textBoxTextColourId, POWDER_BLUE);
-    getLookAndFeel().setColour(juce::Slider::textBoxOutlineColourId, CALEDON_BLUE);
-
-    getLookAndFeel().setColour(juce::TextButton::buttonColourId, POWDER_BLUE);
-    getLookAndFeel().setColour(juce::TextButton::buttonOnColourId, CALEDON_BLUE);
-    getLookAndFeel().setColour(juce::TextButton::textColourOffId, CALEDON_BLUE);
-    getLookAndFeel().setColour(juce::TextButton::textColourOnId, POWDER_BLUE);
+    quality.setFont(juce::Font(15.0f));
+    quality.setColour(juce::Label::textColourId, lookAndFeel->HONEYDEW);
+    quality.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(quality);
 
     // Attach parameters to UI and add listeners
     linkButtonAttachment = new juce::AudioProcessorValueTreeState::ButtonAttachment(
@@ -69,16 +63,27 @@ CombinerAudioProcessorEditor::CombinerAudioProcessorEditor (CombinerAudioProcess
     setupFrequencySliders();
 
     setSize (600, 300);
+
+    // the governor changes the slope from the audio thread, so poll for it
+    startTimerHz(4);
 }
 
 CombinerAudioProcessorEditor::~CombinerAudioProcessorEditor()
 {
+    // the processor outlives its editor, and would otherwise keep calling parameterChanged() on a deleted listener
+    stopTimer();
+    audioProcessor.parameters.removeParameterListener(LINKED_ID, this);
+    audioProcessor.parameters.removeParameterListener(SLOPE_ID, this);
+    audioProcessor.parameters.removeParameterListener(LOPASS_FREQ_ID, this);
+    audioProcessor.parameters.removeParameterListener(HIPASS_FREQ_ID, this);
+
+    setLookAndFeel(nullptr);
 }
 
 //==============================================================================
 void CombinerAudioProcessorEditor::paint (juce::Graphics& g)
 {
-    g.fillAll(PRUSSIAN_BLUE);
+    g.fillAll(lookAndFeel->PRUSSIAN_BLUE);
 }
 
 void CombinerAudioProcessorEditor::resized()
@@ -96,6 +101,7 @@ void CombinerAudioProcessorEditor::resized()
     // create a grid, and assign each element to it's area
     juce::Rectangle<int> titleArea = juce::Rectangle<int>(0, 0, width, oneSixthHeight);
     title.setBounds(titleArea);
+    quality.setBounds(titleArea.removeFromRight(oneThirdWidth));
 
     juce::Rectangle<int> leftLabelArea = juce::Rectangle<int>(0, oneSixthHeight, oneThirdWidth, oneSixthHeight);
     lopassfilter.setBounds(leftLabelArea);
@@ -123,6 +129,8 @@ void CombinerAudioProcessorEditor::parameterChanged(const juce::String& paramete
 {
     if (parameterID == LINKED_ID)
     {
+        COMBINER_TRACE_INSTANT("editor.linkChanged")
+
         // make sure the link button is updated in UI
         bool newState = newValue < 0.5f;
         if (!newState)
@@ -132,16 +140,17 @@ void CombinerAudioProcessorEditor::parameterChanged(const juce::String& paramete
     }
     else if (parameterID == SLOPE_ID)
     {
+        COMBINER_TRACE_INSTANT("editor.slopeChanged")
+
         // update UI for new slope
         unsigned int idx = round(newValue);
         for (unsigned int i{ 0 }; i < 3; ++i)
             slopeButtons[i]->setToggleState(i == idx, juce::dontSendNotification);
-
-        // inform the audio processor that data has changed
-        audioProcessor.resetAndPrepare();
     }
     else if (parameterID == LOPASS_FREQ_ID || parameterID == HIPASS_FREQ_ID)
     {
+        COMBINER_TRACE_INSTANT("editor.frequencyChanged")
+
         // if the channels are linked, update the values of the opposite one
         if (*(audioProcessor.parameters.getRawParameterValue(LINKED_ID)) > 0.5f)
         {
@@ -154,12 +163,19 @@ void CombinerAudioProcessorEditor::parameterChanged(const juce::String& paramete
                 lpfFreqSlider.setValue(newValue, juce::dontSendNotification);
             }
         }
-
-        // inform the processor of the change
-        audioProcessor.updateFrequencies(false, true);
     }
 }
 
+void CombinerAudioProcessorEditor::timerCallback()
+{
+    const int selectedSlope = int(round(audioProcessor.parameters.getRawParameterValue(SLOPE_ID)->load()));
+    const int activeSlope = audioProcessor.getActiveSlope();
+
+    const juce::String text = activeSlope < selectedSlope ? "Reduced to " + slopes[activeSlope] + " dB/8ve" : juce::String();
+    if (quality.getText() != text)
+        quality.setText(text, juce::dontSendNotification);
+}
+
 void CombinerAudioProcessorEditor::buttonStateChanged(juce::Button* button){}
 void CombinerAudioProcessorEditor::buttonClicked(juce::Button* button)
 {
@@ -181,8 +197,8 @@ void CombinerAudioProcessorEditor::buttonClicked(juce::Button* button)
             if (slopeButtons.getUnchecked(index) == button) break;
 
         // inform the processor of the change
+        COMBINER_TRACE_INSTANT("editor.slopeClicked")
         audioProcessor.parameters.getRawParameterValue(SLOPE_ID)->store(index);
-        audioProcessor.resetAndPrepare(); 
     }
 }
 
@@ -253,6 +269,4 @@ void CombinerAudioProcessorEditor::setupFrequencySliders()
 
     addAndMakeVisible(lpfFreqSlider);
     addAndMakeVisible(hpfFreqSlider);
-
-    audioProcessor.updateFrequencies(true, true);
 }
\ No newline at end of file
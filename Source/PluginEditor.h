@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "CombinerLookAndFeel.h"
 
 //==============================================================================
 /**
@@ -17,7 +18,8 @@
 class CombinerAudioProcessorEditor  : 
     public juce::AudioProcessorEditor,
     public juce::AudioProcessorValueTreeState::Listener,
-    public juce::Button::Listener
+    public juce::Button::Listener,
+    private juce::Timer
 {
 public:
     CombinerAudioProcessorEditor (CombinerAudioProcessor&);
@@ -36,11 +38,14 @@ public:
 private:
     CombinerAudioProcessor& audioProcessor;
 
+    // shared by every editor, and must outlive the components below
+    juce::SharedResourcePointer<CombinerLookAndFeel> lookAndFeel;
+
     // UI Elements
     juce::TextButton linkButton;
     juce::OwnedArray<juce::TextButton> slopeButtons;
     juce::Slider lpfFreqSlider, hpfFreqSlider;
-    juce::Label lopassfilter, hipassfilter, title;
+    juce::Label lopassfilter, hipassfilter, title, quality;
 
     // UI Element Listeners
     juce::ScopedPointer<juce::AudioProcessorValueTreeState::ButtonAttachment> linkButtonAttachment;
@@ -50,12 +55,6 @@ private:
     const juce::String LINK_TEXT = juce::String("<- LINK ->");
     const juce::String UNLINK_TEXT = juce::String("<- UNLINK ->");
 
-    // Colours
-    const juce::Colour HONEYDEW = juce::Colour(0xD8, 0xF1, 0xD0);
-    const juce::Colour POWDER_BLUE = juce::Colour(0xA8, 0xDA, 0xDC);
-    const juce::Colour CALEDON_BLUE = juce::Colour(0x45, 0x7B, 0x9D);
-    const juce::Colour PRUSSIAN_BLUE = juce::Colour(0x1D, 0x35, 0x57);
-
     /**
     * Helper function to create the link/unlink button
     */
@@ -71,6 +70,11 @@ private:
     */
     void setupFrequencySliders();
 
+    /**
+    * Shows the slope the filters are running at when the quality governor has lowered it
+    */
+    void timerCallback() override;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CombinerAudioProcessorEditor)
 };
 
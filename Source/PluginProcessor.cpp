@@ -19,6 +19,7 @@ CombinerAudioProcessor::CombinerAudioProcessor()
         .withInput("Input 2", juce::AudioChannelSet::stereo(), true)
 #endif
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+        .withOutput("Output 2", juce::AudioChannelSet::stereo(), false)
 #endif
     ),
 #endif
@@ -28,14 +29,20 @@ CombinerAudioProcessor::CombinerAudioProcessor()
             std::make_unique<juce::AudioParameterBool>(LINKED_ID, LINKED_NAME, true),
             std::make_unique<juce::AudioParameterChoice>(SLOPE_ID, SLOPE_NAME, slopes, 1),
             std::make_unique<juce::AudioParameterFloat>(LOPASS_FREQ_ID, LOPASS_FREQ_NAME, frequencyRange, 750.0f),
-            std::make_unique<juce::AudioParameterFloat>(HIPASS_FREQ_ID, HIPASS_FREQ_NAME, frequencyRange, 750.0f)
+            std::make_unique<juce::AudioParameterFloat>(HIPASS_FREQ_ID, HIPASS_FREQ_NAME, frequencyRange, 750.0f),
+            std::make_unique<juce::AudioParameterChoice>(ENGINE_ID, ENGINE_NAME, engines, 0),
+            std::make_unique<juce::AudioParameterFloat>(ENVELOPE_DEPTH_ID, ENVELOPE_DEPTH_NAME, -4.0f, 4.0f, 0.0f),
+            std::make_unique<juce::AudioParameterFloat>(ENVELOPE_ATTACK_ID, ENVELOPE_ATTACK_NAME, 0.1f, 100.0f, 10.0f),
+            std::make_unique<juce::AudioParameterFloat>(ENVELOPE_RELEASE_ID, ENVELOPE_RELEASE_NAME, 1.0f, 1000.0f, 100.0f),
+            std::make_unique<juce::AudioParameterBool>(GOVERNOR_ID, GOVERNOR_NAME, false),
+            std::make_unique<juce::AudioParameterFloat>(GOVERNOR_THRESHOLD_ID, GOVERNOR_THRESHOLD_NAME, 0.05f, 1.0f, 0.5f)
         })
 {
 }
 
 CombinerAudioProcessor::~CombinerAudioProcessor()
 {
-
+    cancelPendingUpdate();
 }
 
 //======================= JUCE Utility Functions ===============================
@@ -102,7 +109,32 @@ void CombinerAudioProcessor::changeProgramName (int index, const juce::String& n
 //======================= JUCE Playback Functions ==============================
 void CombinerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    resetAndPrepare();
+    loadMonitor.prepare(sampleRate);
+    scratchBuffer.setSize(kernelLanes, juce::jmax(samplesPerBlock, 1));
+    segmentedRenderer.prepare(samplesPerBlock);
+    for (auto& filters : crossovers)
+    {
+        filters.setKernel(kernelOverride);
+        filters.prepare(sampleRate);
+        filters.setOffline(isNonRealtime(), segmentedRenderer.canSplit(samplesPerBlock));
+    }
+    modulatedCrossover.prepare(sampleRate);
+    spectralCrossover.prepare(sampleRate);
+    updateEngine();
+
+    // the host is not playing, so the latency can be reported straight away
+    cancelPendingUpdate();
+    setLatencySamples(engineLatency.load());
+
+    // start at the selected slope without a crossfade
+    governor.prepare(sampleRate);
+    activeSlope = int(round(parameters.getRawParameterValue(SLOPE_ID)->load()));
+    fadeLength = juce::jmax(int(fadeSeconds * sampleRate), 1);
+    fadeRemaining = 0;
+    crossfadedLastBlock = false;
+    fadeBuffer.setSize(kernelLanes, Crossover::tileLength);
+
+    updateFrequencies(true, true);
 }
 
 void CombinerAudioProcessor::releaseResources()
@@ -129,6 +161,18 @@ bool CombinerAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
         return false;
    #endif
 
+    // The second input and second output are optional, but must match the main layout when enabled
+    auto secondInput = layouts.getChannelSet(true, 1);
+    auto secondOutput = layouts.getChannelSet(false, 1);
+    if (!secondInput.isDisabled() && secondInput != layouts.getMainOutputChannelSet())
+        return false;
+    if (!secondOutput.isDisabled() && secondOutput != layouts.getMainOutputChannelSet())
+        return false;
+
+    // Either combine two inputs or split one input, not both
+    if (!secondInput.isDisabled() && !secondOutput.isDisabled())
+        return false;
+
     return true;
   #endif
 }
@@ -137,6 +181,8 @@ bool CombinerAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 void CombinerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    ProcessLoadMonitor::ScopedBlock blockTimer(loadMonitor, buffer.getNumSamples());
+    COMBINER_TRACE_SCOPE("processBlock")
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -144,27 +190,227 @@ void CombinerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    //process lopass
-    unsigned int channelNo{ 0 };
-    for (; channelNo < 2; ++channelNo)
+    updateCutoffs();
+    updateEngine();
+    updateQuality(buffer.getNumSamples());
+
+    if (isSplitting())
+        processSplit(buffer);
+    else
+        processCombine(buffer);
+}
+
+void CombinerAudioProcessor::processCombine(juce::AudioBuffer<float>& buffer)
+{
+    auto lopassBuffer = getBusBuffer(buffer, true, 0);
+    auto hipassBuffer = getBusBuffer(buffer, true, 1);
+
+    // both bands are refiltered even when only one has changed, which costs nothing extra (see kernelLanes)
+    Crossover::combineTiles(getSpan(lopassBuffer), getSpan(hipassBuffer), getSpan(scratchBuffer), getTileLength(),
+                            [this](float* const* lanes, int numSamples) { filterLanes(lanes, numSamples, false, true); });
+}
+
+bool CombinerAudioProcessor::isSplitting() const
+{
+    auto* secondInput = getBus(true, 1);
+    auto* secondOutput = getBus(false, 1);
+
+    return (secondInput == nullptr || !secondInput->isEnabled())
+        && secondOutput != nullptr && secondOutput->isEnabled();
+}
+
+void CombinerAudioProcessor::processSplit(juce::AudioBuffer<float>& buffer)
+{
+    auto lopassBuffer = getBusBuffer(buffer, false, 0);
+    auto hipassBuffer = getBusBuffer(buffer, false, 1);
+
+    // when both bands share a cutoff the hipass is derived from the allpass they sum to, at no extra cost (see kernelLanes),
+    // so the bands add back up exactly. During a crossfade the old filters keep their own lanes (see crossfadeLanes())
+    const bool complementary = crossover->isComplementary() && engine == Engine::classic;
+
+    Crossover::splitTiles(getSpan(lopassBuffer), getSpan(hipassBuffer), getSpan(scratchBuffer), getTileLength(), complementary,
+                          [this, complementary](float* const* lanes, int numSamples) { filterLanes(lanes, numSamples, complementary, false); });
+}
+
+void CombinerAudioProcessor::updateCutoffs()
+{
+    const double lopass = parameters.getRawParameterValue(LOPASS_FREQ_ID)->load();
+    const double hipass = parameters.getRawParameterValue(HIPASS_FREQ_ID)->load();
+    if (lopass != fc[0] || hipass != fc[1])
     {
-        auto channelData = buffer.getWritePointer(channelNo);
-        for (unsigned int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
-        {
-            channelData[sampleNo] = filterSample(channelData[sampleNo], channelNo, FilterType::lopass);
-        }
+        fc[0] = lopass;
+        fc[1] = hipass;
+        prepare();
+    }
+}
+
+void CombinerAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(engineLatency.load());
+    updateHostDisplay();
+}
+
+void CombinerAudioProcessor::updateEngine()
+{
+    const auto selected = static_cast<Engine>(int(round(parameters.getRawParameterValue(ENGINE_ID)->load())));
+    if (selected != engine)
+    {
+        COMBINER_TRACE_INSTANT("engineChanged")
+        reset();
+        engine = selected;
+
+        // only the spectral engine delays its output. Hosts may reconfigure from inside setLatencySamples(),
+        // so it is called from the message thread
+        engineLatency = engine == Engine::spectral ? SpectralCrossover::latencySamples : 0;
+        triggerAsyncUpdate();
+    }
+
+    if (engine == Engine::spectral)
+        spectralCrossover.setCutoffs(fc[0], fc[1]);
+
+    if (engine == Engine::modulated)
+    {
+        modulatedCrossover.setSlope(int(round(parameters.getRawParameterValue(SLOPE_ID)->load())));
+        modulatedCrossover.setCutoffs(fc[0], fc[1]);
+        modulatedCrossover.setEnvelope(parameters.getRawParameterValue(ENVELOPE_DEPTH_ID)->load(),
+                                       parameters.getRawParameterValue(ENVELOPE_ATTACK_ID)->load(),
+                                       parameters.getRawParameterValue(ENVELOPE_RELEASE_ID)->load());
+    }
+}
+
+void CombinerAudioProcessor::updateQuality(int numSamples)
+{
+    // only the classic engine changes slope, and offline renders have no deadline to meet
+    const bool governed = parameters.getRawParameterValue(GOVERNOR_ID)->load() > 0.5f
+        && engine == Engine::classic && !isNonRealtime();
+
+    if (governed)
+    {
+        governor.setThreshold(parameters.getRawParameterValue(GOVERNOR_THRESHOLD_ID)->load());
+
+        // a crossfade runs two sets of filters, so its blocks say nothing about the cost of the new slope.
+        // Counting them could make the first step down look overloaded and drop straight to the lowest slope
+        if (!crossfadedLastBlock)
+            governor.addBlock(loadMonitor.getLastLoad(), numSamples);
+    }
+    else
+        governor.reset();
+
+    crossfadedLastBlock = false;
+
+    const int selectedSlope = int(round(parameters.getRawParameterValue(SLOPE_ID)->load()));
+    const int slope = governed ? juce::jmin(selectedSlope, governor.getSlopeLimit()) : selectedSlope;
+    if (slope == activeSlope.load(std::memory_order_relaxed))
+        return;
+
+    COMBINER_TRACE_INSTANT("slopeChanged")
+
+    // keep the old filters running while the new ones start from silence, unless there is no time limit to hide the switch
+    std::swap(crossover, fadingCrossover);
+    fadeRemaining = isNonRealtime() ? 0 : fadeLength;
+    fadeUsesSplitCoefficients = fadingCrossover->usesSplitCoefficients();
+
+    crossover->setCutoffs(fc[0], fc[1]);
+    crossover->setSlope(slope);
+    {
+        COMBINER_TRACE_SCOPE("coefficientSwap")
+        crossover->update();
+    }
+    crossover->reset();
+    activeSlope = slope;
+}
+
+int CombinerAudioProcessor::getTileLength() const
+{
+    // offline blocks are left whole so the segmented renderer can split them across threads
+    return isNonRealtime() ? scratchBuffer.getNumSamples() : juce::jmin(Crossover::tileLength, scratchBuffer.getNumSamples());
+}
+
+void CombinerAudioProcessor::filterLanes(float* const* lanes, int numSamples, bool useSplitCoefficients, bool sumPairs)
+{
+    if (engine == Engine::modulated)
+    {
+        modulatedCrossover.process(lanes, numSamples, sumPairs);
+        return;
+    }
+
+    if (engine == Engine::spectral)
+    {
+        spectralCrossover.process(lanes, numSamples, sumPairs);
+        return;
+    }
+
+    // offline, the crossover runs the block kernel where it is faster, or where long blocks will be split across threads
+    const bool offline = isNonRealtime();
+    if (offline != crossover->isOffline())
+    {
+        COMBINER_TRACE_INSTANT("renderModeChanged")
+        for (auto& filters : crossovers)
+            filters.setOffline(offline, segmentedRenderer.canSplit(scratchBuffer.getNumSamples()));
+
+        // the kernel may have changed under the fade, and offline renders switch slope without one
+        fadeRemaining = 0;
+    }
+
+    if (fadeRemaining > 0 && !offline)
+    {
+        crossfadeLanes(lanes, numSamples, useSplitCoefficients, sumPairs);
+        return;
+    }
+
+    if (crossover->usesOfflineKernel() && segmentedRenderer.process(crossover->getKernel(), crossover->getOfflineCoefficients(useSplitCoefficients),
+                                             crossover->getOfflineState(useSplitCoefficients), lanes, numSamples, sumPairs))
+        return;
+
+    crossover->process(lanes, numSamples, useSplitCoefficients, sumPairs);
+}
+
+void CombinerAudioProcessor::crossfadeLanes(float* const* lanes, int numSamples, bool useSplitCoefficients, bool sumPairs)
+{
+    // realtime tiles always fit in the fade buffer
+    jassert(numSamples <= fadeBuffer.getNumSamples());
+
+    float* fadeLanes[kernelLanes];
+    for (int lane{ 0 }; lane < kernelLanes; ++lane)
+    {
+        fadeLanes[lane] = fadeBuffer.getWritePointer(lane);
+        juce::FloatVectorOperations::copy(fadeLanes[lane], lanes[lane], numSamples);
     }
 
-    //process hipass
-    for (; channelNo < 4; ++channelNo)
+    // switching the old filters to the other lanes would restart them, so they keep the ones they had before the change
+    const bool fadingSplitCoefficients = fadeUsesSplitCoefficients && !sumPairs;
+    fadingCrossover->process(fadeLanes, numSamples, fadingSplitCoefficients, sumPairs);
+    crossover->process(lanes, numSamples, useSplitCoefficients, sumPairs);
+
+    // then convert their last two lanes to what the new filters wrote there: allpass = hipass + lopass
+    if (fadingSplitCoefficients != useSplitCoefficients)
     {
-        auto inputData = buffer.getReadPointer(channelNo);
-        auto outputData = buffer.getWritePointer(channelNo % 2);
-        for (unsigned int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
+        for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
         {
-            outputData[sampleNo] += filterSample(inputData[sampleNo], channelNo % 2, FilterType::hipass);
+            if (useSplitCoefficients)
+                juce::FloatVectorOperations::add(fadeLanes[channelNo + 2], fadeLanes[channelNo], numSamples);
+            else
+                juce::FloatVectorOperations::subtract(fadeLanes[channelNo + 2], fadeLanes[channelNo], numSamples);
         }
     }
+
+    // the old filters fade out linearly as the new ones fade in
+    const int numOutputLanes = sumPairs ? 2 : kernelLanes;
+    for (int sampleNo{ 0 }; sampleNo < numSamples; ++sampleNo)
+    {
+        const float oldGain = float(juce::jmax(fadeRemaining - sampleNo, 0)) / float(fadeLength);
+        for (int lane{ 0 }; lane < numOutputLanes; ++lane)
+            lanes[lane][sampleNo] += (fadeLanes[lane][sampleNo] - lanes[lane][sampleNo]) * oldGain;
+    }
+
+    fadeRemaining = juce::jmax(fadeRemaining - numSamples, 0);
+    crossfadedLastBlock = true;
+}
+
+AudioSpan CombinerAudioProcessor::getSpan(juce::AudioBuffer<float>& buffer)
+{
+    // buses with no channels are filtered as silence, and only the first two channels of any bus are used
+    return { buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples() };
 }
 
 //==============================================================================
@@ -187,12 +433,18 @@ void CombinerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     juce::XmlElement* linked = new juce::XmlElement(juce::String("PARAM"));
     juce::XmlElement* lpf = new juce::XmlElement(juce::String("PARAM"));
     juce::XmlElement* slope = new juce::XmlElement(juce::String("PARAM"));
+    juce::XmlElement* engine = new juce::XmlElement(juce::String("PARAM"));
+    juce::XmlElement* envelopeDepth = new juce::XmlElement(juce::String("PARAM"));
+    juce::XmlElement* envelopeAttack = new juce::XmlElement(juce::String("PARAM"));
+    juce::XmlElement* envelopeRelease = new juce::XmlElement(juce::String("PARAM"));
+    juce::XmlElement* governorEnabled = new juce::XmlElement(juce::String("PARAM"));
+    juce::XmlElement* governorThreshold = new juce::XmlElement(juce::String("PARAM"));
 
     // create xml elements for each parameter
     hpf->setAttribute(juce::Identifier("id"), HIPASS_FREQ_ID);
     hpf->setAttribute(
         juce::Identifier("value"),
-        juce::String(fc[1])
+        juce::String(parameters.getRawParameterValue(HIPASS_FREQ_ID)->load())
     );
 
     linked->setAttribute(juce::Identifier("id"), LINKED_ID);
@@ -204,7 +456,7 @@ void CombinerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     lpf->setAttribute(juce::Identifier("id"), LOPASS_FREQ_ID);
     lpf->setAttribute(
         juce::Identifier("value"),
-        juce::String(fc[0])
+        juce::String(parameters.getRawParameterValue(LOPASS_FREQ_ID)->load())
     );
 
     slope->setAttribute(juce::Identifier("id"), SLOPE_ID);
@@ -213,11 +465,53 @@ void CombinerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
         juce::String(parameters.getRawParameterValue(SLOPE_ID)->load())
     );
 
+    engine->setAttribute(juce::Identifier("id"), ENGINE_ID);
+    engine->setAttribute(
+        juce::Identifier("value"),
+        juce::String(parameters.getRawParameterValue(ENGINE_ID)->load())
+    );
+
+    envelopeDepth->setAttribute(juce::Identifier("id"), ENVELOPE_DEPTH_ID);
+    envelopeDepth->setAttribute(
+        juce::Identifier("value"),
+        juce::String(parameters.getRawParameterValue(ENVELOPE_DEPTH_ID)->load())
+    );
+
+    envelopeAttack->setAttribute(juce::Identifier("id"), ENVELOPE_ATTACK_ID);
+    envelopeAttack->setAttribute(
+        juce::Identifier("value"),
+        juce::String(parameters.getRawParameterValue(ENVELOPE_ATTACK_ID)->load())
+    );
+
+    envelopeRelease->setAttribute(juce::Identifier("id"), ENVELOPE_RELEASE_ID);
+    envelopeRelease->setAttribute(
+        juce::Identifier("value"),
+        juce::String(parameters.getRawParameterValue(ENVELOPE_RELEASE_ID)->load())
+    );
+
+    governorEnabled->setAttribute(juce::Identifier("id"), GOVERNOR_ID);
+    governorEnabled->setAttribute(
+        juce::Identifier("value"),
+        juce::String(parameters.getRawParameterValue(GOVERNOR_ID)->load())
+    );
+
+    governorThreshold->setAttribute(juce::Identifier("id"), GOVERNOR_THRESHOLD_ID);
+    governorThreshold->setAttribute(
+        juce::Identifier("value"),
+        juce::String(parameters.getRawParameterValue(GOVERNOR_THRESHOLD_ID)->load())
+    );
+
     // add parameter elements to main element
     combiner->addChildElement(hpf);
     combiner->addChildElement(linked);
     combiner->addChildElement(lpf);
     combiner->addChildElement(slope);
+    combiner->addChildElement(engine);
+    combiner->addChildElement(envelopeDepth);
+    combiner->addChildElement(envelopeAttack);
+    combiner->addChildElement(envelopeRelease);
+    combiner->addChildElement(governorEnabled);
+    combiner->addChildElement(governorThreshold);
 
     //write to output
     copyXmlToBinary(*combiner, destData);
@@ -241,232 +535,44 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 
 void CombinerAudioProcessor::reset()
 {
-    // set all sample of all channels of memory to 0
-    for (unsigned int channel{ 0 }; channel < 4; ++channel)
-    {
-        for (unsigned int i{ 0 }; i < 5; ++i)
-        {
-            loX[channel][i] = 0.0;
-            loY[channel][i] = 0.0;
-            hiX[channel][i] = 0.0;
-            hiY[channel][i] = 0.0;
-        }
-    }
+    COMBINER_TRACE_INSTANT("reset")
+
+    crossover->reset();
+    fadeRemaining = 0;
+    modulatedCrossover.reset();
+    spectralCrossover.reset();
 }
 
 void CombinerAudioProcessor::prepare()
 {
-    prepHelper(FilterType::lopass);
-    calculateCoefficients(FilterType::lopass);
-    prepHelper(FilterType::hipass);
-    calculateCoefficients(FilterType::hipass);
+    COMBINER_TRACE_SCOPE("prepare")
+    // changes of slope are crossfaded on the audio thread by updateQuality()
+    crossover->setSlope(activeSlope.load(std::memory_order_relaxed));
+    crossover->setCutoffs(fc[0], fc[1]);
+    {
+        COMBINER_TRACE_SCOPE("coefficientSwap")
+        crossover->update();
+    }
 }
 
 void CombinerAudioProcessor::resetAndPrepare()
 {
+    COMBINER_TRACE_SCOPE("resetAndPrepare")
     reset();
     prepare();
 }
 
+void CombinerAudioProcessor::setKernelOverride(KernelType type)
+{
+    kernelOverride = type;
+}
+
 void CombinerAudioProcessor::updateFrequencies(bool callReset, bool callPrepare)
 {
+    COMBINER_TRACE_SCOPE("updateFrequencies")
     fc[0] = parameters.getRawParameterValue(LOPASS_FREQ_ID)->load();
     fc[1] = parameters.getRawParameterValue(HIPASS_FREQ_ID)->load();
 
     if (callReset) reset();
     if (callPrepare) prepare();
 }
-
-void CombinerAudioProcessor::prepHelper(FilterType type)
-{
-    unsigned int mode = int(round(parameters.getRawParameterValue(SLOPE_ID)->load()));
-    switch (mode)
-    {
-    case 0:
-        prepHelper2(type);
-        break;
-    case 1:
-        prepHelper4(type);
-        break;
-    case 2:
-        prepHelper8(type);
-        break;
-    default:
-        throw new _exception;
-        break;
-    }
-}
-
-void CombinerAudioProcessor::prepHelper2(FilterType type)
-{
-    int i = type == FilterType::lopass ? 0 : 1;
-
-    w[i][1] = juce::MathConstants<double>::pi * fc[i];
-    w[i][2] = w[i][1] * w[i][1];
-    k[i][1] = w[i][1] / tan(w[i][1] / getSampleRate());
-    k[i][2] = k[i][1] * k[i][1];
-
-    tmp1 = 2 * k[i][1] * w[i][1];
-    tmp2 = k[i][2] + w[i][2] + tmp1;
-}
-
-void CombinerAudioProcessor::prepHelper4(FilterType type)
-{
-    int i = type == FilterType::lopass ? 0 : 1;
-
-    w[i][1] = juce::MathConstants<double>::twoPi * fc[i];
-    w[i][2] = w[i][1] * w[i][1];
-    w[i][3] = w[i][2] * w[i][1];
-    w[i][4] = w[i][2] * w[i][2];
-
-    k[i][1] = w[i][1] / tan(juce::MathConstants<double>::pi * fc[i] / getSampleRate());
-    k[i][2] = k[i][1] * k[i][1];
-    k[i][3] = k[i][2] * k[i][1];
-    k[i][4] = k[i][2] * k[i][2];
-
-    tmp1 = juce::MathConstants<double>::sqrt2 * w[i][3] * k[i][1];
-    tmp2 = juce::MathConstants<double>::sqrt2 * w[i][1] * k[i][3];
-    tmp_a = 4 * w[i][2] * k[i][2] + 2 * tmp1 + k[i][4] + 2 * tmp2 + w[i][4];
-}
-
-void CombinerAudioProcessor::prepHelper8(FilterType type) 
-{
-    prepHelper4(type);
-}
-
-void CombinerAudioProcessor::calculateCoefficients(FilterType type)
-{
-    unsigned int mode = round(parameters.getRawParameterValue(SLOPE_ID)->load());
-    switch (mode)
-    {
-    case 0:
-        calculateCoefficients2(type);
-        break;
-    case 1:
-        calculateCoefficients4(type);
-        break;
-    case 2:
-        calculateCoefficients8(type);
-        break;
-    default:
-        throw new _exception;
-        break;
-    }
-}
-
-void CombinerAudioProcessor::calculateCoefficients2(FilterType type)
-{
-    int i = type == FilterType::lopass ? 0 : 1;
-
-    a[i][0] = (type == FilterType::lopass ? w[i][2] : k[i][2]) / tmp2;
-    a[i][1] = (type == FilterType::lopass ? (2.0 * w[i][2]) : (-2.0 * k[i][2])) / tmp2;
-    a[i][2] = a[i][0];
-
-    b[i][1] = (2.0 * w[i][2] - 2.0 * k[i][2]) / tmp2;
-    b[i][2] = (k[i][2] + w[i][2] - tmp1) / tmp2;
-}
-
-void CombinerAudioProcessor::calculateCoefficients4(FilterType type)
-{
-    int i = type == FilterType::lopass ? 0 : 1;
-
-    b[i][1] = (4 * (w[i][4] + tmp1 - k[i][4] - tmp2)) / tmp_a;
-    b[i][2] = (6 * w[i][4] - 8 * w[i][2] * k[i][2] + 6 * k[i][4]) / tmp_a;
-    b[i][3] = (4 * (w[i][4] - tmp1 + tmp2 - k[i][4])) / tmp_a;
-    b[i][4] = (k[i][4] - 2 * tmp1 + w[i][4] - 2 * tmp2 + 4 * w[i][2] * k[i][2]) / tmp_a;
-
-    a[i][0] = (type == FilterType::lopass ? w[i][4] : k[i][4]) / tmp_a;
-    a[i][1] = (type == FilterType::lopass ? 4 : -4) * a[i][0];
-    a[i][2] = 6 * a[i][0];
-    a[i][3] = a[i][1];
-    a[i][4] = a[i][0];
-}
-
-void CombinerAudioProcessor::calculateCoefficients8(FilterType type)
-{
-    calculateCoefficients4(type);
-}
-
-float CombinerAudioProcessor::filterSample(float inputSample, unsigned int channelNo, FilterType type)
-{
-    unsigned int mode = round(parameters.getRawParameterValue(SLOPE_ID)->load());
-    switch (mode)
-    {
-    case 0:
-        return filterSample2(inputSample, channelNo, type);
-    case 1:
-        return filterSample4(inputSample, channelNo, type);
-    case 2:
-        return filterSample8(inputSample, channelNo, type);
-    default:
-        throw new _exception;
-        break;
-    }
-}
-
-float CombinerAudioProcessor::filterSample2(float inputSample, unsigned int channelNo, FilterType type)
-{
-    // select filter type
-    unsigned int mode = type == FilterType::lopass ? 0 : 1;
-    double* x_mem = type == FilterType::lopass ? loX[channelNo] : hiX[channelNo];
-    double* y_mem = type == FilterType::lopass ? loY[channelNo] : hiY[channelNo];
-
-    //process
-    double output = a[mode][0] * inputSample
-        + a[mode][1] * x_mem[1]
-        + a[mode][2] * x_mem[2]
-        - b[mode][1] * y_mem[1]
-        - b[mode][2] * y_mem[2];
-
-    //propogate memory
-    x_mem[2] = x_mem[1];
-    x_mem[1] = inputSample;
-    y_mem[2] = y_mem[1];
-    y_mem[1] = output;
-
-    //apply polarity flip to hpf and return
-    return (type == FilterType::lopass ? output : (-1.0 * output));
-}
-
-float CombinerAudioProcessor::filterSample4(float inputSample, unsigned int channelNo, FilterType type, unsigned int stage)
-{
-    if (stage < 0 || stage > 1) throw new _exception;
-
-    //select the filter type
-    unsigned int mode = type == FilterType::hipass ? 1 : 0;
-    double* x_mem = type == FilterType::hipass ? hiX[channelNo + 2 * stage] : loX[channelNo + 2 * stage];
-    double* y_mem = type == FilterType::hipass ? hiY[channelNo + 2 * stage] : loY[channelNo + 2 * stage];
-
-    //Apply transfer function
-    double output = a[mode][0] * inputSample
-        + a[mode][1] * x_mem[1]
-        + a[mode][2] * x_mem[2]
-        + a[mode][3] * x_mem[3]
-        + a[mode][4] * x_mem[4]
-        - b[mode][1] * y_mem[1]
-        - b[mode][2] * y_mem[2]
-        - b[mode][3] * y_mem[3]
-        - b[mode][4] * y_mem[4];
-
-    //propogate memory
-    x_mem[4] = x_mem[3];
-    x_mem[3] = x_mem[2];
-    x_mem[2] = x_mem[1];
-    x_mem[1] = inputSample;
-    y_mem[4] = y_mem[3];
-    y_mem[3] = y_mem[2];
-    y_mem[2] = y_mem[1];
-    y_mem[1] = output;
-
-    return output;
-}
-
-float CombinerAudioProcessor::filterSample8(float inputSample, unsigned int channelNo, FilterType type)
-{
-    return filterSample4(
-        filterSample4(inputSample, channelNo, type, 0),
-        channelNo, 
-        type, 
-        1
-    );
-}
\ No newline at end of file
@@ -1,6 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "ProcessLoad.h"
+#include "Core/Crossover.h"
+#include "SegmentedRenderer.h"
+#include "ModulatedCrossover.h"
+#include "SpectralCrossover.h"
+#include "QualityGovernor.h"
+#include "Trace.h"
 
 // Parameter Identifiers
 #define LINKED_ID "linked"
@@ -11,10 +18,23 @@
 #define LOPASS_FREQ_NAME "Low-Pass Cutoff"
 #define HIPASS_FREQ_ID "hpf_freq_id"
 #define HIPASS_FREQ_NAME "High-Pass Cutoff"
+#define ENGINE_ID "engine_id"
+#define ENGINE_NAME "Engine"
+#define ENVELOPE_DEPTH_ID "env_depth_id"
+#define ENVELOPE_DEPTH_NAME "Envelope Depth"
+#define ENVELOPE_ATTACK_ID "env_attack_id"
+#define ENVELOPE_ATTACK_NAME "Envelope Attack"
+#define ENVELOPE_RELEASE_ID "env_release_id"
+#define ENVELOPE_RELEASE_NAME "Envelope Release"
+#define GOVERNOR_ID "governor_id"
+#define GOVERNOR_NAME "Quality Governor"
+#define GOVERNOR_THRESHOLD_ID "governor_threshold_id"
+#define GOVERNOR_THRESHOLD_NAME "Governor Threshold"
 
 // Global Parameters
-enum class FilterType { lopass, hipass };
+enum class Engine { classic, modulated, spectral };
 const juce::StringArray slopes("12", "24", "48");
+const juce::StringArray engines("Classic", "Modulated", "Spectral");
 const juce::NormalisableRange<float> frequencyRange(20.0f, 20000.0f, 0.1f, 0.25f);
 
 //==============================================================================
@@ -24,7 +44,8 @@ const juce::NormalisableRange<float> frequencyRange(20.0f, 20000.0f, 0.1f, 0.25f
 * @author Ryan Logan
 * 
 */
-class CombinerAudioProcessor  : public juce::AudioProcessor
+class CombinerAudioProcessor  : public juce::AudioProcessor,
+                                private juce::AsyncUpdater
 {
 public:
     // Holds all paramters visible in the UI
@@ -72,7 +93,7 @@ public:
     */
     void reset();
     /**
-    * Calculates the values of all the required filter co-efficients for both filters
+    * Calculates the values of all the required filter co-efficients for both filters from the parameters
     */
     void prepare();
     /**
@@ -93,134 +114,155 @@ public:
     */
     void updateFrequencies(bool callReset = false, bool callPrepare = false);
 
+    //================================ Diagnostics =================================
+    /**
+    * Gives access to the timing of this instance's processBlock calls
+    * @return The monitor for this instance
+    * @see ProcessLoadMonitor::getProcessStatistics()
+    */
+    ProcessLoadMonitor& getLoadMonitor() { return loadMonitor; }
+
+    /**
+    * Forces a build of the filter kernel to be used instead of the fastest one, for testing.
+    * Takes effect on the next call to prepareToPlay()
+    * @param type The kernel to use, or automatic to pick the fastest one supported by this machine
+    */
+    void setKernelOverride(KernelType type);
+
+    /**
+    * @return The build of the filter kernel chosen in prepareToPlay()
+    */
+    KernelType getKernelType() const { return crossover->getKernel().type; }
+
+    /**
+    * Gives access to the renderer that splits long offline blocks across threads
+    * @return The renderer for this instance
+    */
+    SegmentedRenderer& getSegmentedRenderer() { return segmentedRenderer; }
+
+    /**
+    * Reads the slope the filters are running at, which is lower than the Slope parameter
+    * while the quality governor is saving CPU. Safe to call from any thread.
+    * @return 0, 1 or 2 for the 12, 24 and 48 dB/8ve slopes
+    */
+    int getActiveSlope() const { return activeSlope.load(std::memory_order_relaxed); }
+
 private:
     unsigned int numChannels{ 2 };
 
+    // keeps the trace writer running while tracing is compiled in
+    COMBINER_TRACE_SESSION
+
+    // measures the cost of processBlock
+    ProcessLoadMonitor loadMonitor;
+
     // centre frequency for lo-pass and hi-pass respectively
     double fc[2]{ 750.0, 750.0 };
 
-    // intermediate paramters for filters
-    // rows are left and right
-    // columns are used differently based on filter chosen
-    double w[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
-    double k[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+    // the lopass and hipass filters, and the kernel that runs them
+    // the current filters and those from before the last change of slope take turns in crossovers, so a change
+    // of slope swaps two pointers rather than copying the filters on the audio thread
+    Crossover crossovers[2];
+    Crossover* crossover{ &crossovers[0] };
+    KernelType kernelOverride{ KernelType::automatic };
 
-    // memory for the filters
-    // first two rows are left and right
-    // second two rows are left and right for the second stage of a cascaded filter
-    double loX[4][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0},
-                      {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
-    double loY[4][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0},
-                      {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
-    double hiX[4][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0},
-                      {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
-    double hiY[4][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0},
-                      {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+    // lowers the slope while blocks take too long, when the governor is switched on
+    QualityGovernor governor;
+    std::atomic<int> activeSlope{ 1 };
 
-    // filter coefficients
-    // second row is only for the second stage of cascaded filters
-    double a[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
-    double b[2][5]{ {0.0,0.0,0.0,0.0,0.0},{0.0,0.0,0.0,0.0,0.0} };
+    // the filters from before the last change of slope, faded out over fadeLength samples
+    Crossover* fadingCrossover{ &crossovers[1] };
+    bool fadeUsesSplitCoefficients{ false }, crossfadedLastBlock{ false };
+    juce::AudioBuffer<float> fadeBuffer;
+    int fadeLength{ 1 }, fadeRemaining{ 0 };
+    static constexpr double fadeSeconds = 0.02;
 
-    // misc internal filter parameters
-    double tmp1{ 0.0 }, tmp2{ 0.0 }, tmp_a{ 0.0 };
+    // splits long offline blocks across threads
+    SegmentedRenderer segmentedRenderer;
 
-    /**
-    * Helper function that calculates all intermediary parameters for a filter
-    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
-    * @see prepHelper2()
-    * @see prepHelper4()
-    * @see prepHelper8()
-    */
-    void prepHelper(FilterType type);
+    // state variable filters used instead of the kernel when the engine is set to Modulated
+    ModulatedCrossover modulatedCrossover;
+
+    // per-bin selection used instead of the kernel when the engine is set to Spectral
+    SpectralCrossover spectralCrossover;
+
+    // the engine processing the current block
+    Engine engine{ Engine::classic };
+
+    // the latency of the current engine, reported to the host from the message thread
+    std::atomic<int> engineLatency{ 0 };
+
+    // stands in for missing or mono channels
+    juce::AudioBuffer<float> scratchBuffer;
 
     /**
-    * Helper function that calculates all intermediary parameters for a filter
-    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
+    * Reads the cutoff parameters at the start of a block, and recalculates the filters if either has changed.
+    * The editor never touches the filters, so automation and restored state take effect whether it is open or not.
     */
-    void prepHelper2(FilterType type);
+    void updateCutoffs();
 
     /**
-    * Helper function that calculates all intermediary parameters for a filter
-    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
+    * Reads the engine and envelope parameters at the start of a block.
+    * Clears the filter memory when switching between engines, and has the new latency reported from the message thread.
     */
-    void prepHelper4(FilterType type);
+    void updateEngine();
 
     /**
-    * Helper function that calculates all intermediary parameters for a filter
-    * @param type The type of filter. If the lopass and hipass have the same cutoff frequency this function only needs to be called once with any value for type.
-    * @see prepHelper4()
+    * Reports the latency of the current engine to the host
     */
-    void prepHelper8(FilterType type);
+    void handleAsyncUpdate() override;
 
     /**
-    * Helper function to calculate the filter coefficients
-    * @param type Chooses whether to update the lopass or hipass filter
-    * @see calculateCoefficients2()
-    * @see calculateCoefficients4()
-    * @see calculateCoefficients8()
+    * Feeds the load of the last block to the quality governor, and starts a crossfade
+    * to new filters when the slope they should run at has changed
+    * @param numSamples The number of samples in the block about to be processed
     */
-    void calculateCoefficients(FilterType type);
+    void updateQuality(int numSamples);
 
     /**
-    * Helper function to calculate the filter coefficients
-    * @param type Chooses whether to update the lopass or hipass filter
+    * Runs the filters from before the last change of slope alongside the current ones, and fades between them
+    * @see filterLanes()
     */
-    void calculateCoefficients2(FilterType type);
+    void crossfadeLanes(float* const* lanes, int numSamples, bool useSplitCoefficients, bool sumPairs);
 
     /**
-    * Helper function to calculate the filter coefficients
-    * @param type Chooses whether to update the lopass or hipass filter
+    * Checks whether the plugin is splitting a single input onto two outputs, rather than combining two inputs
+    * @return True if the second input is disabled and the second output is enabled
     */
-    void calculateCoefficients4(FilterType type);
+    bool isSplitting() const;
 
     /**
-    * Helper function to calculate the filter coefficients
-    * @param type Chooses whether to update the lopass or hipass filter
-    * @see calculateCoefficients4()
+    * Sums the lopass of the main input with the hipass of the second input onto the main output
+    * @param buffer The buffer passed to processBlock()
     */
-    void calculateCoefficients8(FilterType type);
-    
+    void processCombine(juce::AudioBuffer<float>& buffer);
+
     /**
-    * Applies a filter to the input sample. Choose whether to use a second, fourth, or eigth order Linkwitz-Riley filter
-    * @param inputSample The sample to be processed
-    * @param channelNo The channel number in the filter
-    * @param type The filter to apply
-    * @return The filtered output sample
-    * @see filterSample2
-    * @see filterSample4
-    * @see filterSample8
+    * Splits the main input into a lopass band on the main output and a hipass band on the second output.
+    * When both filters share a cutoff the hipass is derived from the lopass as allpass - lopass.
+    * @param buffer The buffer passed to processBlock()
     */
-    float filterSample(float inputSample, unsigned int channelNo, FilterType type);
+    void processSplit(juce::AudioBuffer<float>& buffer);
 
     /**
-    * Helper function to apply a 2nd order LinkWitz-Riley Filter
-    * @param inputSample The sample to be processed
-    * @param channelNo The channel number in the filter
-    * @param type The filter to apply
-    * @return The filtered output sample
+    * Runs the kernel over every lane, using the block kernel offline where it is faster,
+    * spread over several threads when the block is long enough, or the modulated or spectral crossover when it is selected
+    * @param lanes Lopass left/right then hipass or allpass left/right
+    * @param numSamples The number of samples in each lane
+    * @param useSplitCoefficients True to filter the last two lanes with the allpass rather than the hipass
+    * @param sumPairs True to write the sum of both bands to the first two lanes, leaving the last two unchanged
     */
-    float filterSample2(float inputSample, unsigned int channelNo, FilterType type);
-    
+    void filterLanes(float* const* lanes, int numSamples, bool useSplitCoefficients, bool sumPairs);
+
     /**
-    * Helper function to apply a 4th order LinkWitz-Riley Filter
-    * @param inputSample The sample to be processed
-    * @param channelNo The channel number in the filter
-    * @param type The filter to apply
-    * @param stage When cascading a value of 1 can be supplied to use a different history
-    * @return The filtered output sample
+    * @return The number of samples to process at a time, never more than the scratch buffer holds
     */
-    float filterSample4(float inputSample, unsigned int channelNo, FilterType type, unsigned int stage=0);
-    
+    int getTileLength() const;
+
     /**
-    * Helper function to apply a 8th order LinkWitz-Riley Filter
-    * @param inputSample The sample to be processed
-    * @param channelNo The channel number in the filter
-    * @param type The filter to apply
-    * @return The filtered output sample
-    * @see filterSample4()
+    * @return The channels of a buffer, for Crossover::combineTiles() and Crossover::splitTiles()
     */
-    float filterSample8(float inputSample, unsigned int channelNo, FilterType type);
+    static AudioSpan getSpan(juce::AudioBuffer<float>& buffer);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CombinerAudioProcessor)
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    Measures the cost of processBlock for each instance of the plugin.
+
+  ==============================================================================
+*/
+
+#include "ProcessLoad.h"
+
+namespace
+{
+    // every monitor in the process, so the load of all instances can be summed
+    struct MonitorList
+    {
+        juce::CriticalSection lock;
+        juce::Array<ProcessLoadMonitor*> monitors;
+    };
+
+    MonitorList& getMonitorList()
+    {
+        static MonitorList list;
+        return list;
+    }
+}
+
+//==============================================================================
+double ProcessLoadMonitor::Statistics::getThroughput() const
+{
+    return totalSeconds > 0.0 ? double(numSamples) / totalSeconds : 0.0;
+}
+
+double ProcessLoadMonitor::Statistics::getAverageLoad(double sampleRate) const
+{
+    return numSamples > 0 ? totalSeconds * sampleRate / double(numSamples) : 0.0;
+}
+
+double ProcessLoadMonitor::ProcessStatistics::getSecondsPerInstance() const
+{
+    return numInstances > 0 ? total.totalSeconds / numInstances : 0.0;
+}
+
+//==============================================================================
+ProcessLoadMonitor::ScopedBlock::ScopedBlock(ProcessLoadMonitor& monitorToUse, int numSamplesInBlock)
+    : monitor(monitorToUse), numSamples(numSamplesInBlock), startTicks(juce::Time::getHighResolutionTicks())
+{
+}
+
+ProcessLoadMonitor::ScopedBlock::~ScopedBlock()
+{
+    monitor.addBlock(numSamples, juce::Time::getHighResolutionTicks() - startTicks);
+}
+
+//==============================================================================
+ProcessLoadMonitor::ProcessLoadMonitor()
+{
+    auto& list = getMonitorList();
+    const juce::ScopedLock sl(list.lock);
+    list.monitors.add(this);
+}
+
+ProcessLoadMonitor::~ProcessLoadMonitor()
+{
+    auto& list = getMonitorList();
+    const juce::ScopedLock sl(list.lock);
+    list.monitors.removeFirstMatchingValue(this);
+}
+
+void ProcessLoadMonitor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+}
+
+void ProcessLoadMonitor::setDeadline(double fractionOfBudget)
+{
+    deadline = fractionOfBudget;
+}
+
+void ProcessLoadMonitor::addBlock(int numSamplesInBlock, juce::int64 elapsedTicks)
+{
+    if (numSamplesInBlock <= 0)
+        return;
+
+    // only the audio thread writes, so the totals don't need read-modify-write atomics
+    const double seconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+    const double load = seconds * sampleRate.load(std::memory_order_relaxed) / numSamplesInBlock;
+
+    numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    numSamples.store(numSamples.load(std::memory_order_relaxed) + juce::uint64(numSamplesInBlock), std::memory_order_relaxed);
+    totalTicks.store(totalTicks.load(std::memory_order_relaxed) + elapsedTicks, std::memory_order_relaxed);
+
+    if (elapsedTicks > worstTicks.load(std::memory_order_relaxed))
+        worstTicks.store(elapsedTicks, std::memory_order_relaxed);
+    if (load > worstLoad.load(std::memory_order_relaxed))
+        worstLoad.store(load, std::memory_order_relaxed);
+    if (load > deadline.load(std::memory_order_relaxed))
+        deadlineMisses.store(deadlineMisses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    lastLoad.store(load, std::memory_order_relaxed);
+
+    lastThread.store(juce::Thread::getCurrentThreadId(), std::memory_order_relaxed);
+}
+
+ProcessLoadMonitor::Statistics ProcessLoadMonitor::getStatistics() const
+{
+    Statistics stats;
+    stats.numBlocks = numBlocks.load(std::memory_order_relaxed);
+    stats.numSamples = numSamples.load(std::memory_order_relaxed);
+    stats.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+    stats.totalSeconds = juce::Time::highResolutionTicksToSeconds(totalTicks.load(std::memory_order_relaxed));
+    stats.worstSeconds = juce::Time::highResolutionTicksToSeconds(worstTicks.load(std::memory_order_relaxed));
+    stats.worstLoad = worstLoad.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ProcessLoadMonitor::resetStatistics()
+{
+    numBlocks = 0;
+    numSamples = 0;
+    deadlineMisses = 0;
+    totalTicks = 0;
+    worstTicks = 0;
+    worstLoad = 0.0;
+}
+
+ProcessLoadMonitor::ProcessStatistics ProcessLoadMonitor::getProcessStatistics()
+{
+    ProcessStatistics result;
+    juce::Array<juce::Thread::ThreadID> threads;
+
+    auto& list = getMonitorList();
+    const juce::ScopedLock sl(list.lock);
+
+    for (auto* monitor : list.monitors)
+    {
+        const auto stats = monitor->getStatistics();
+        ++result.numInstances;
+
+        result.total.numBlocks += stats.numBlocks;
+        result.total.numSamples += stats.numSamples;
+        result.total.deadlineMisses += stats.deadlineMisses;
+        result.total.totalSeconds += stats.totalSeconds;
+        result.total.worstSeconds = juce::jmax(result.total.worstSeconds, stats.worstSeconds);
+        result.total.worstLoad = juce::jmax(result.total.worstLoad, stats.worstLoad);
+
+        auto thread = monitor->lastThread.load(std::memory_order_relaxed);
+        if (thread != nullptr && !threads.contains(thread))
+            threads.add(thread);
+    }
+
+    result.numThreads = threads.size();
+    return result;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+* ProcessLoadMonitor
+* Measures the time spent in each call to processBlock against the real-time budget of the block.
+* Every monitor is registered with a process-wide list so the cost of many instances spread
+* over the host's worker threads can be read back together.
+* @author Ryan Logan
+*
+*/
+class ProcessLoadMonitor
+{
+public:
+    /**
+    * Totals gathered by a single monitor, or summed across all of them
+    */
+    struct Statistics
+    {
+        juce::uint64 numBlocks{ 0 };
+        juce::uint64 numSamples{ 0 };
+        juce::uint64 deadlineMisses{ 0 };
+        double totalSeconds{ 0.0 };
+        double worstSeconds{ 0.0 };
+        double worstLoad{ 0.0 };
+
+        /** @return The number of samples processed per second of processing time */
+        double getThroughput() const;
+        /** @return The mean of processing time / real-time budget over all blocks */
+        double getAverageLoad(double sampleRate) const;
+    };
+
+    /**
+    * Totals for every monitor in the process
+    */
+    struct ProcessStatistics
+    {
+        int numInstances{ 0 };
+        int numThreads{ 0 };
+        Statistics total;
+
+        /** @return The mean processing time spent per instance, in seconds */
+        double getSecondsPerInstance() const;
+    };
+
+    /**
+    * Times a single block for as long as it is in scope
+    */
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(ProcessLoadMonitor& monitorToUse, int numSamplesInBlock);
+        ~ScopedBlock();
+
+    private:
+        ProcessLoadMonitor& monitor;
+        const int numSamples;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    ProcessLoadMonitor();
+    ~ProcessLoadMonitor();
+
+    /**
+    * Sets the sample rate used to calculate the budget of each block
+    * @param sampleRate The sample rate passed to prepareToPlay()
+    */
+    void prepare(double sampleRate);
+
+    /**
+    * Sets how much of a block's real-time budget an instance may use before the block counts as a deadline miss
+    * @param fractionOfBudget 1.0 means the block took as long to process as it does to play
+    */
+    void setDeadline(double fractionOfBudget);
+
+    /**
+    * Records a block. Called from the audio thread.
+    * @param numSamples The number of samples in the block
+    * @param elapsedTicks The time taken, in high resolution ticks
+    */
+    void addBlock(int numSamples, juce::int64 elapsedTicks);
+
+    /**
+    * Reads the totals. Safe to call from any thread.
+    * @return The totals since construction or the last call to resetStatistics()
+    */
+    Statistics getStatistics() const;
+
+    /**
+    * Reads the load of the most recent block. Safe to call from any thread.
+    * @return The time spent processing the block divided by its real-time budget
+    */
+    double getLastLoad() const { return lastLoad.load(std::memory_order_relaxed); }
+
+    /**
+    * Clears the totals of this monitor
+    */
+    void resetStatistics();
+
+    /**
+    * Sums the totals of every monitor in the process. Must not be called from the audio thread.
+    * @return The combined totals and the number of instances and host threads they were gathered from
+    */
+    static ProcessStatistics getProcessStatistics();
+
+private:
+    std::atomic<double> sampleRate{ 44100.0 };
+    std::atomic<double> deadline{ 1.0 };
+
+    std::atomic<juce::uint64> numBlocks{ 0 }, numSamples{ 0 }, deadlineMisses{ 0 };
+    std::atomic<juce::int64> totalTicks{ 0 }, worstTicks{ 0 };
+    std::atomic<double> worstLoad{ 0.0 }, lastLoad{ 0.0 };
+
+    // the last host thread this instance was processed on
+    std::atomic<juce::Thread::ThreadID> lastThread{ nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessLoadMonitor)
+};
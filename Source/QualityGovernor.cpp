@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    Lowers the slope of the filters while processBlock is over its budget.
+
+  ==============================================================================
+*/
+
+#include "QualityGovernor.h"
+
+void QualityGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void QualityGovernor::setThreshold(double fractionOfBudget)
+{
+    threshold = fractionOfBudget;
+}
+
+void QualityGovernor::addBlock(double load, int numSamples)
+{
+    int limit = slopeLimit.load(std::memory_order_relaxed);
+
+    if (load > threshold)
+    {
+        samplesUnder = 0;
+        if (++blocksOver >= blocksBeforeStepDown && limit > minSlope)
+        {
+            --limit;
+            blocksOver = 0;
+        }
+    }
+    else
+    {
+        blocksOver = 0;
+        if (load < threshold * recoveryRatio)
+        {
+            samplesUnder += numSamples;
+            if (samplesUnder >= juce::int64(recoverySeconds * sampleRate) && limit < maxSlope)
+            {
+                ++limit;
+                samplesUnder = 0;
+            }
+        }
+        else
+            samplesUnder = 0;
+    }
+
+    slopeLimit.store(limit, std::memory_order_relaxed);
+}
+
+void QualityGovernor::reset()
+{
+    blocksOver = 0;
+    samplesUnder = 0;
+    slopeLimit.store(maxSlope, std::memory_order_relaxed);
+}
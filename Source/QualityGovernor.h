@@ -0,0 +1,65 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+* QualityGovernor
+* Lowers the slope the processor may use while its blocks take too much of their real-time budget,
+* one step at a time, and raises it again once the load has stayed well below the threshold for a while.
+* Only the audio thread updates the governor; the current limit can be read from any thread.
+* @author Ryan Logan
+*
+*/
+class QualityGovernor
+{
+public:
+    // Slope indices from the steepest down to the cheapest
+    static constexpr int maxSlope = 2;
+    static constexpr int minSlope = 0;
+
+    /**
+    * Sets the sample rate used to time the recovery, and restores the full slope
+    * @param sampleRate The sample rate passed to prepareToPlay()
+    */
+    void prepare(double sampleRate);
+
+    /**
+    * @param fractionOfBudget The load above which the slope is lowered. 1.0 means a block took as long to process as it does to play
+    */
+    void setThreshold(double fractionOfBudget);
+
+    /**
+    * Records the load of a block. Called from the audio thread.
+    * @param load The time spent processing the block divided by its real-time budget
+    * @param numSamples The number of samples in the block
+    */
+    void addBlock(double load, int numSamples);
+
+    /**
+    * Restores the full slope and clears the history of loads
+    */
+    void reset();
+
+    /**
+    * @return The steepest slope index currently allowed, from minSlope to maxSlope
+    */
+    int getSlopeLimit() const { return slopeLimit.load(std::memory_order_relaxed); }
+
+private:
+    // consecutive blocks over the threshold before stepping down
+    static constexpr int blocksBeforeStepDown = 8;
+    // the load must stay below this fraction of the threshold to step back up,
+    // which leaves room for the steeper slope to cost more
+    static constexpr double recoveryRatio = 0.5;
+    // and must stay there for this long
+    static constexpr double recoverySeconds = 2.0;
+
+    double sampleRate{ 44100.0 };
+    double threshold{ 0.5 };
+
+    int blocksOver{ 0 };
+    juce::int64 samplesUnder{ 0 };
+
+    std::atomic<int> slopeLimit{ maxSlope };
+};
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    Splits a long offline render across several threads.
+
+  ==============================================================================
+*/
+
+#include "SegmentedRenderer.h"
+
+namespace
+{
+    // shortest segment worth handing to another thread. The pre-roll is rarely under 2048 samples, so in practice
+    // segments are bounded by warmUpRatio, and this only matters for filters that settle very quickly
+    constexpr int minSegmentLength = 4096;
+
+    // a segment must be at least this many times longer than its pre-roll
+    constexpr int warmUpRatio = 4;
+
+    // the impulse response is checked in windows long enough to span the zero crossings of a 20 Hz cycle
+    constexpr int warmUpWindow = 1024;
+
+    // pre-rolls are capped at about ten seconds at 192 kHz
+    constexpr int maxWarmUpLength = 1 << 21;
+}
+
+//==============================================================================
+SegmentedRenderer::SharedPool::SharedPool()
+    : pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))
+{
+}
+
+//==============================================================================
+class SegmentedRenderer::SegmentJob : public juce::ThreadPoolJob
+{
+public:
+    SegmentJob(SegmentedRenderer& owner, int segment)
+        : juce::ThreadPoolJob("Segment " + juce::String(segment)), owner(owner), segment(segment)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        owner.renderSegment(segment);
+        if (--owner.numRemaining == 0)
+            owner.finished.signal();
+        return jobHasFinished;
+    }
+
+private:
+    SegmentedRenderer& owner;
+    const int segment;
+};
+
+//==============================================================================
+SegmentedRenderer::SegmentedRenderer()
+{
+}
+
+SegmentedRenderer::~SegmentedRenderer()
+{
+    // process() waits for its jobs, but make sure none of them outlive this
+    for (auto* job : jobs)
+        sharedPool->pool.waitForJobToFinish(job, -1);
+}
+
+void SegmentedRenderer::prepare(int maximumBlockSize)
+{
+    maxBlockSize = juce::jmax(0, maximumBlockSize);
+
+    const int maxSegments = sharedPool->pool.getNumThreads() + 1;
+    segmentStates.allocate(size_t(maxSegments), true);
+
+    // no segment is pre-rolled for more than a quarter of its length
+    numWarmUpSamples = size_t(kernelLanes) * size_t(maxBlockSize / warmUpRatio);
+    warmUpSamples.allocate(juce::jmax(size_t(1), numWarmUpSamples), true);
+
+    while (jobs.size() < maxSegments)
+        jobs.add(new SegmentJob(*this, jobs.size()));
+}
+
+void SegmentedRenderer::setTolerance(double maxError)
+{
+    tolerance = maxError;
+}
+
+bool SegmentedRenderer::canSplit(int numSamples) const
+{
+    // the shortest segment the pre-roll allows, since the filters are not known yet
+    return juce::SystemStats::getNumCpus() > 1 && numSamples >= 2 * juce::jmax(minSegmentLength, warmUpRatio * warmUpWindow);
+}
+
+int SegmentedRenderer::calculateWarmUpLength(const SectionCoefficients& sections, double maxError)
+{
+    // run an impulse through every lane until a whole window of the response is below the tolerance
+    double x[maxSections][3][kernelLanes]{};
+    double y[maxSections][3][kernelLanes]{};
+    double windowPeak{ 0.0 };
+
+    for (int sampleNo{ 0 }; sampleNo < maxWarmUpLength; ++sampleNo)
+    {
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+        {
+            double input = sampleNo == 0 ? 1.0 : 0.0;
+            for (int section{ 0 }; section < sections.numSections; ++section)
+            {
+                const double output = sections.a[section][0][lane] * input
+                    + sections.a[section][1][lane] * x[section][1][lane]
+                    + sections.a[section][2][lane] * x[section][2][lane]
+                    - sections.b[section][1][lane] * y[section][1][lane]
+                    - sections.b[section][2][lane] * y[section][2][lane];
+
+                x[section][2][lane] = x[section][1][lane];
+                x[section][1][lane] = input;
+                y[section][2][lane] = y[section][1][lane];
+                y[section][1][lane] = output;
+                input = output;
+            }
+            windowPeak = juce::jmax(windowPeak, std::abs(input));
+        }
+
+        if ((sampleNo + 1) % warmUpWindow == 0)
+        {
+            if (windowPeak < maxError)
+                return sampleNo + 1;
+            windowPeak = 0.0;
+        }
+    }
+
+    return maxWarmUpLength;
+}
+
+bool SegmentedRenderer::process(const FilterKernel& kernel, const OfflineCoefficients& coefficients, OfflineState& state,
+                                float* const* lanes, int numSamples, bool sumPairs)
+{
+    if (kernel.processOffline == nullptr || numSamples > maxBlockSize)
+        return false;
+
+    const auto& sections = coefficients.sections;
+    if (warmUpTolerance != tolerance || warmUpSections.numSections != sections.numSections
+        || std::memcmp(warmUpSections.a, sections.a, sizeof(sections.a)) != 0
+        || std::memcmp(warmUpSections.b, sections.b, sizeof(sections.b)) != 0)
+    {
+        warmUpSections = sections;
+        warmUpTolerance = tolerance;
+        warmUpLength = calculateWarmUpLength(sections, tolerance);
+    }
+
+    // the calling thread renders the first segment while the pool renders the rest
+    const int segmentLength = juce::jmax(minSegmentLength, warmUpRatio * warmUpLength);
+    const int numSegments = juce::jmin(numSamples / segmentLength, jobs.size());
+    if (numSegments < 2)
+        return false;
+
+    render.kernel = &kernel;
+    render.coefficients = &coefficients;
+    render.lanes = lanes;
+    render.numSamples = numSamples;
+    render.numSegments = numSegments;
+    render.sumPairs = sumPairs;
+
+    // the segments are filtered in place, so copy the input each one is pre-rolled over before any of them start
+    jassert(size_t(kernelLanes) * size_t(warmUpLength) * size_t(numSegments) <= numWarmUpSamples);
+    for (int segment{ 1 }; segment < numSegments; ++segment)
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+            std::memcpy(warmUpSamples + size_t(segment * kernelLanes + lane) * size_t(warmUpLength),
+                        lanes[lane] + getSegmentStart(segment) - warmUpLength, sizeof(float) * size_t(warmUpLength));
+
+    segmentStates[0] = state;
+    numRemaining = numSegments - 1;
+    finished.reset();
+
+    for (int segment{ 1 }; segment < numSegments; ++segment)
+        sharedPool->pool.addJob(jobs[segment], false);
+
+    renderSegment(0);
+    finished.wait();
+
+    // a job signals before the pool lets go of it, so wait for that before the job can be added again
+    for (int segment{ 1 }; segment < numSegments; ++segment)
+        sharedPool->pool.waitForJobToFinish(jobs[segment], -1);
+
+    state = segmentStates[numSegments - 1];
+    return true;
+}
+
+void SegmentedRenderer::renderSegment(int segment)
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto& segmentState = segmentStates[segment];
+
+    if (segment > 0)
+    {
+        float* warmUpLanes[kernelLanes];
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+            warmUpLanes[lane] = warmUpSamples + size_t(segment * kernelLanes + lane) * size_t(warmUpLength);
+
+        segmentState = {};
+        render.kernel->processOffline(*render.coefficients, segmentState, warmUpLanes, warmUpLength, false);
+    }
+
+    float* segmentLanes[kernelLanes];
+    for (int lane{ 0 }; lane < kernelLanes; ++lane)
+        segmentLanes[lane] = render.lanes[lane] + getSegmentStart(segment);
+
+    render.kernel->processOffline(*render.coefficients, segmentState, segmentLanes, getSegmentLength(segment), render.sumPairs);
+}
+
+int SegmentedRenderer::getSegmentStart(int segment) const
+{
+    return segment * (render.numSamples / render.numSegments);
+}
+
+int SegmentedRenderer::getSegmentLength(int segment) const
+{
+    return segment == render.numSegments - 1 ? render.numSamples - getSegmentStart(segment) : render.numSamples / render.numSegments;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Core/FilterKernels.h"
+
+//==============================================================================
+/**
+* SegmentedRenderer
+* Renders a long offline buffer on several cores at once. The buffer is cut into segments and each
+* segment after the first starts from silent filter memory, pre-rolled over the input just before it
+* for long enough that its memory converges on the memory a serial render would have reached.
+* Everything a render needs is allocated by prepare(), so process() does not allocate.
+* @author Ryan Logan
+*
+*/
+class SegmentedRenderer
+{
+public:
+    SegmentedRenderer();
+    ~SegmentedRenderer();
+
+    /**
+    * Allocates the memory and jobs for buffers of up to a given length. Must not be called during process()
+    * @param maximumBlockSize The longest buffer that will be passed to process()
+    */
+    void prepare(int maximumBlockSize);
+
+    /**
+    * Sets how far the memory of a pre-rolled segment may be from a serial render when it starts
+    * @param maxError The largest impulse response sample left after the pre-roll, e.g. 1.0e-6 for -120 dB
+    */
+    void setTolerance(double maxError);
+
+    /**
+    * Filters every lane of a buffer, splitting it into segments that are processed in parallel
+    * @param kernel The build of the kernel to use
+    * @param coefficients The block form of each lane
+    * @param state The memory of each lane, updated as if the whole buffer had been processed in one go
+    * @param lanes One pointer per lane to the samples to be processed
+    * @param numSamples The number of samples in each lane
+    * @param sumPairs If true the first two lanes receive the sum of the first and last pairs of filtered lanes
+    * @return False, without processing anything, if the buffer is too short to be worth splitting
+    *         or longer than the maximum passed to prepare()
+    */
+    bool process(const FilterKernel& kernel, const OfflineCoefficients& coefficients, OfflineState& state,
+                 float* const* lanes, int numSamples, bool sumPairs);
+
+    /**
+    * Checks whether blocks of a given length could be split at all, before the filters are known
+    * @param numSamples The longest block the host will send
+    * @return True if this machine has cores to spare and the blocks are long enough for at least two segments
+    */
+    bool canSplit(int numSamples) const;
+
+    /**
+    * Measures how long the impulse response of every lane takes to fall below a tolerance
+    * @param sections The biquads of each lane
+    * @param maxError The tolerance
+    * @return The number of samples a segment must be pre-rolled for
+    */
+    static int calculateWarmUpLength(const SectionCoefficients& sections, double maxError);
+
+private:
+    // shared by every instance so that several plugins bouncing at once don't oversubscribe the machine
+    struct SharedPool
+    {
+        SharedPool();
+        juce::ThreadPool pool;
+    };
+    juce::SharedResourcePointer<SharedPool> sharedPool;
+
+    // renders one segment of the current buffer on the pool
+    class SegmentJob;
+    juce::OwnedArray<SegmentJob> jobs;
+
+    // the buffer being rendered by process()
+    struct Render
+    {
+        const FilterKernel* kernel{ nullptr };
+        const OfflineCoefficients* coefficients{ nullptr };
+        float* const* lanes{ nullptr };
+        int numSamples{ 0 };
+        int numSegments{ 0 };
+        bool sumPairs{ false };
+    };
+    Render render;
+    std::atomic<int> numRemaining{ 0 };
+    juce::WaitableEvent finished;
+
+    double tolerance{ 1.0e-6 };
+    int maxBlockSize{ 0 };
+
+    // the pre-roll for the most recent coefficients, recalculated whenever they change
+    SectionCoefficients warmUpSections{};
+    double warmUpTolerance{ 0.0 };
+    int warmUpLength{ 0 };
+
+    // copies of the input each segment is pre-rolled over, one run of warmUpLength samples per lane per segment.
+    // Each segment is at least warmUpRatio times longer than its pre-roll, so the copies never add up
+    // to more than kernelLanes * maxBlockSize / warmUpRatio samples
+    juce::HeapBlock<float> warmUpSamples;
+    size_t numWarmUpSamples{ 0 };
+
+    // the memory of each segment
+    juce::HeapBlock<OfflineState> segmentStates;
+
+    /**
+    * Pre-rolls a segment, then filters it in place
+    * @param segment The segment of the current render, 0 for the one that continues from the caller's memory
+    */
+    void renderSegment(int segment);
+
+    /** @return The first sample of a segment of the current render */
+    int getSegmentStart(int segment) const;
+
+    /** @return The length of a segment of the current render, with any remainder going to the last one */
+    int getSegmentLength(int segment) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SegmentedRenderer)
+};
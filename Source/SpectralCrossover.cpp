@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    Short-time Fourier transform crossover with a brickwall mask per band.
+
+  ==============================================================================
+*/
+
+#include "SpectralCrossover.h"
+
+void SpectralCrossover::allocate()
+{
+    fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+    analysisWindow.malloc(fftLength);
+    synthesisWindow.malloc(fftLength);
+    history.setSize(kernelLanes, fftLength);
+    overlap.setSize(kernelLanes, fftLength);
+    output.setSize(kernelLanes, hopLength);
+    frames.setSize(2, 2 * fftLength);
+
+    // a periodic hann window, squared and overlapped every quarter frame, sums to 1.5
+    for (int sampleNo{ 0 }; sampleNo < fftLength; ++sampleNo)
+    {
+        analysisWindow[sampleNo] = static_cast<float>(0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * sampleNo / fftLength));
+        synthesisWindow[sampleNo] = analysisWindow[sampleNo] / 1.5f;
+    }
+
+    for (auto& mask : masks)
+        mask.calloc(2 * numBins);
+}
+
+void SpectralCrossover::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    // nothing is allocated until the plugin is about to play, so loading an instance stays cheap
+    if (fft == nullptr)
+        allocate();
+
+    // force the masks to be rebuilt for the new bin frequencies
+    const double lopass = cutoffs[0], hipass = cutoffs[1];
+    cutoffs[0] = cutoffs[1] = 0.0;
+    setCutoffs(lopass, hipass);
+
+    reset();
+}
+
+void SpectralCrossover::reset()
+{
+    history.clear();
+    overlap.clear();
+    output.clear();
+    hopPosition = 0;
+}
+
+void SpectralCrossover::setCutoffs(double lopass, double hipass)
+{
+    if (lopass == cutoffs[0] && hipass == cutoffs[1])
+        return;
+
+    cutoffs[0] = lopass;
+    cutoffs[1] = hipass;
+
+    // the masks are built by prepare() if they don't exist yet
+    if (fft == nullptr)
+        return;
+
+    for (int bin{ 0 }; bin < numBins; ++bin)
+    {
+        const double frequency = bin * sampleRate / fftLength;
+        const float lopassGain = frequency < lopass ? 1.0f : 0.0f;
+        const float hipassGain = frequency >= hipass ? 1.0f : 0.0f;
+        masks[0][2 * bin] = masks[0][2 * bin + 1] = lopassGain;
+        masks[1][2 * bin] = masks[1][2 * bin + 1] = hipassGain;
+    }
+}
+
+void SpectralCrossover::process(float* const* lanes, int numSamples, bool sumPairs)
+{
+    jassert(fft != nullptr);
+    const int numOutputLanes = sumPairs ? 2 : kernelLanes;
+
+    for (int sampleNo{ 0 }; sampleNo < numSamples;)
+    {
+        const int numToCopy = juce::jmin(numSamples - sampleNo, hopLength - hopPosition);
+
+        // read the input before the output overwrites it
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+            juce::FloatVectorOperations::copy(history.getWritePointer(lane, fftLength - hopLength + hopPosition),
+                                              lanes[lane] + sampleNo, numToCopy);
+        for (int lane{ 0 }; lane < numOutputLanes; ++lane)
+            juce::FloatVectorOperations::copy(lanes[lane] + sampleNo, output.getReadPointer(lane, hopPosition), numToCopy);
+
+        sampleNo += numToCopy;
+        hopPosition += numToCopy;
+        if (hopPosition == hopLength)
+        {
+            processFrame(sumPairs);
+            hopPosition = 0;
+        }
+    }
+}
+
+void SpectralCrossover::processFrame(bool sumPairs)
+{
+    float* lopassFrame = frames.getWritePointer(0);
+    float* hipassFrame = frames.getWritePointer(1);
+
+    for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+    {
+        // lane channelNo is the lopass and lane channelNo + 2 the hipass
+        for (int band{ 0 }; band < 2; ++band)
+        {
+            float* frame = frames.getWritePointer(band);
+            juce::FloatVectorOperations::multiply(frame, history.getReadPointer(channelNo + 2 * band), analysisWindow, fftLength);
+            juce::FloatVectorOperations::clear(frame + fftLength, fftLength);
+            fft->performRealOnlyForwardTransform(frame, true);
+            juce::FloatVectorOperations::multiply(frame, masks[band], 2 * numBins);
+        }
+
+        if (sumPairs)
+        {
+            // one inverse transform for both bands
+            juce::FloatVectorOperations::add(lopassFrame, hipassFrame, 2 * numBins);
+            fft->performRealOnlyInverseTransform(lopassFrame);
+            juce::FloatVectorOperations::addWithMultiply(overlap.getWritePointer(channelNo), lopassFrame, synthesisWindow, fftLength);
+        }
+        else
+        {
+            for (int band{ 0 }; band < 2; ++band)
+            {
+                float* frame = frames.getWritePointer(band);
+                fft->performRealOnlyInverseTransform(frame);
+                juce::FloatVectorOperations::addWithMultiply(overlap.getWritePointer(channelNo + 2 * band), frame, synthesisWindow, fftLength);
+            }
+        }
+    }
+
+    // the first hop of the overlap is complete, so play it next and slide the rest along
+    const int numOutputLanes = sumPairs ? 2 : kernelLanes;
+    for (int lane{ 0 }; lane < kernelLanes; ++lane)
+    {
+        if (lane < numOutputLanes)
+            output.copyFrom(lane, 0, overlap, lane, 0, hopLength);
+
+        float* laneOverlap = overlap.getWritePointer(lane);
+        std::memmove(laneOverlap, laneOverlap + hopLength, (fftLength - hopLength) * sizeof(float));
+        juce::FloatVectorOperations::clear(laneOverlap + fftLength - hopLength, hopLength);
+
+        float* laneHistory = history.getWritePointer(lane);
+        std::memmove(laneHistory, laneHistory + hopLength, (fftLength - hopLength) * sizeof(float));
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Core/FilterKernels.h"
+
+//==============================================================================
+/**
+* SpectralCrossover
+* Chooses each frequency bin from either input rather than filtering them, using a short-time
+* Fourier transform with 4096 point frames at 75% overlap. Every bin below the lopass cutoff is
+* taken from the lopass input and every bin above the hipass cutoff from the hipass input, which
+* gives a far steeper crossover than any of the filter slopes at the cost of a frame of latency.
+* All buffers are allocated by the first call to prepare(), never on the audio thread.
+* @author Ryan Logan
+*
+*/
+class SpectralCrossover
+{
+public:
+    // Frames are 2^fftOrder samples long, and a new frame starts every hopLength samples
+    static constexpr int fftOrder = 12;
+    static constexpr int fftLength = 1 << fftOrder;
+    static constexpr int hopLength = fftLength / 4;
+    static constexpr int numBins = fftLength / 2 + 1;
+
+    // Each input sample reaches the output this many samples later, at any sample rate
+    static constexpr int latencySamples = fftLength;
+
+    /**
+    * Sets the sample rate and clears all memory, allocating the frames on the first call
+    * @param sampleRate The sample rate passed to prepareToPlay()
+    */
+    void prepare(double sampleRate);
+
+    /**
+    * Clears the frames, so the output is silent until a frame of new input has been read
+    */
+    void reset();
+
+    /**
+    * Rebuilds the masks if either cutoff has changed. The new masks apply from the next frame
+    * @param lopass Bins below this frequency in Hz are taken from the lopass input
+    * @param hipass Bins at or above this frequency in Hz are taken from the hipass input
+    */
+    void setCutoffs(double lopass, double hipass);
+
+    /**
+    * Processes every lane in place, delayed by latencySamples
+    * @param lanes Lopass left/right then hipass left/right
+    * @param numSamples The number of samples in each lane
+    * @param sumPairs If true the lopass lanes receive the sum of both bands, and the hipass lanes are left as they were
+    */
+    void process(float* const* lanes, int numSamples, bool sumPairs);
+
+private:
+    std::unique_ptr<juce::dsp::FFT> fft;
+    double sampleRate{ 44100.0 };
+    double cutoffs[2]{ 0.0, 0.0 };
+
+    // hann window for analysis, and the same window scaled so the overlapping frames add up to 1 for synthesis
+    juce::HeapBlock<float> analysisWindow, synthesisWindow;
+
+    // the gain of each bin for the lopass and hipass lanes, repeated for the real and imaginary parts
+    // so they multiply the output of the transform directly
+    juce::HeapBlock<float> masks[2];
+
+    // the last fftLength input samples of each lane, the newest hop being filled in as it arrives
+    juce::AudioBuffer<float> history;
+    // the overlapping output frames not yet played, one channel per lane
+    juce::AudioBuffer<float> overlap;
+    // the hop of output being played while the next hop of input is read
+    juce::AudioBuffer<float> output;
+    // working space for the transforms, which need twice the frame length
+    juce::AudioBuffer<float> frames;
+
+    // how far through the current hop the input and output have got
+    int hopPosition{ 0 };
+
+    /**
+    * Creates the transform, windows, masks and frames
+    */
+    void allocate();
+
+    /**
+    * Transforms the latest frame of every lane, applies the masks, and adds the result to the overlap.
+    * The first hop of the overlap then becomes the next hop of output
+    * @param sumPairs If true the masked lopass and hipass lanes are summed before the inverse transform
+    */
+    void processFrame(bool sumPairs);
+};
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    Lock-free capture of audio and editor events to a Chrome trace file.
+
+  ==============================================================================
+*/
+
+#include "Trace.h"
+
+#if COMBINER_ENABLE_TRACING
+
+namespace
+{
+    struct Event
+    {
+        const char* name;
+        const void* instance;
+        juce::int64 ticks;
+        char phase;
+    };
+
+    // a ring is active once a thread has claimed it and written its id. Its thread, or the writer thread when
+    // recycling it, holds it busy while changing it, so the ring can never be freed in the middle of a record
+    enum class RingState { free, active, busy };
+
+    // each ring has a single writer, its owning thread, and a single reader, the writer thread
+    struct Ring
+    {
+        static constexpr juce::uint32 capacity = 4096;
+
+        std::atomic<RingState> state{ RingState::free };
+        std::atomic<juce::uint64> threadId{ 0 };
+        std::atomic<juce::uint32> writeIndex{ 0 };
+        std::atomic<juce::uint32> readIndex{ 0 };
+        Event events[capacity];
+    };
+
+    // the most threads that can record at once. A thread that starts while all of them are in use records nothing
+    constexpr int maxThreads = 32;
+    Ring rings[maxThreads];
+    std::atomic<juce::uint32> numDropped{ 0 };
+
+    // the writer frees a ring once its thread has recorded nothing for this many flushes, about five seconds
+    constexpr int idleFlushesBeforeRecycling = 50;
+
+    /**
+    * Finds the ring a thread claimed earlier. Rings are found by thread id rather than through a thread_local,
+    * whose first use can allocate on the audio thread when the plugin is loaded as a shared library
+    */
+    Ring* findRing(juce::uint64 threadId)
+    {
+        for (auto& ring : rings)
+            if (ring.threadId.load(std::memory_order_relaxed) == threadId)
+                return &ring;
+
+        return nullptr;
+    }
+
+    Ring* claimRing(juce::uint64 threadId)
+    {
+        for (auto& ring : rings)
+        {
+            auto expected = RingState::free;
+            if (ring.state.compare_exchange_strong(expected, RingState::busy, std::memory_order_acquire))
+            {
+                // the writer only reads the thread id after seeing the ring active
+                ring.threadId.store(threadId, std::memory_order_relaxed);
+                ring.state.store(RingState::active, std::memory_order_release);
+                return &ring;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+void Trace::record(const char* name, char phase, const void* instance)
+{
+    const auto threadId = juce::uint64(juce::pointer_sized_uint(juce::Thread::getCurrentThreadId()));
+    auto* ring = findRing(threadId);
+    if (ring == nullptr)
+        ring = claimRing(threadId);
+
+    // the ring may have been recycled, and even claimed by another thread, since it was found
+    auto expected = RingState::active;
+    if (ring == nullptr || !ring->state.compare_exchange_strong(expected, RingState::busy, std::memory_order_acquire))
+    {
+        ++numDropped;
+        return;
+    }
+
+    const auto write = ring->writeIndex.load(std::memory_order_relaxed);
+    if (ring->threadId.load(std::memory_order_relaxed) != threadId
+        || write - ring->readIndex.load(std::memory_order_acquire) >= Ring::capacity)
+    {
+        ring->state.store(RingState::active, std::memory_order_release);
+        ++numDropped;
+        return;
+    }
+
+    ring->events[write % Ring::capacity] = { name, instance, juce::Time::getHighResolutionTicks(), phase };
+    ring->writeIndex.store(write + 1, std::memory_order_release);
+    ring->state.store(RingState::active, std::memory_order_release);
+}
+
+//==============================================================================
+class Trace::Session::Writer : public juce::Thread
+{
+public:
+    Writer() : juce::Thread("Combiner Trace")
+    {
+        auto path = juce::SystemStats::getEnvironmentVariable("COMBINER_TRACE_FILE", {});
+        auto file = path.isNotEmpty()
+            ? juce::File(path)
+            : juce::File::getSpecialLocation(juce::File::tempDirectory)
+                  .getChildFile("Combiner-trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+
+        file.deleteFile();
+        stream = file.createOutputStream();
+        if (stream != nullptr)
+            *stream << "[\n";
+
+        startThread();
+    }
+
+    ~Writer() override
+    {
+        stopThread(1000);
+        flush();
+
+        if (stream != nullptr)
+        {
+            // the trailing metadata event keeps the array valid without tracking the last comma
+            *stream << "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":1,\"args\":{\"count\":"
+                    << juce::String(numDropped.load()) << "}}\n]\n";
+            stream->flush();
+        }
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            flush();
+            wait(100);
+        }
+    }
+
+private:
+    std::unique_ptr<juce::FileOutputStream> stream;
+
+    // how many flushes in a row each ring has had nothing new
+    int idleFlushes[maxThreads]{};
+
+    void flush()
+    {
+        if (stream == nullptr)
+            return;
+
+        for (int ringNo{ 0 }; ringNo < maxThreads; ++ringNo)
+        {
+            auto& ring = rings[ringNo];
+            if (ring.state.load(std::memory_order_acquire) == RingState::free)
+                continue;
+
+            idleFlushes[ringNo] = drain(ring) == 0 ? idleFlushes[ringNo] + 1 : 0;
+
+            // threads can exit without telling anyone, so a ring that has long been idle is freed for another thread.
+            // If its thread is still alive, it claims a new ring the next time it records
+            auto expected = RingState::active;
+            if (idleFlushes[ringNo] >= idleFlushesBeforeRecycling
+                && ring.state.compare_exchange_strong(expected, RingState::busy, std::memory_order_acquire))
+            {
+                drain(ring);
+                ring.threadId.store(0, std::memory_order_relaxed);
+                ring.readIndex.store(0, std::memory_order_relaxed);
+                ring.writeIndex.store(0, std::memory_order_relaxed);
+                ring.state.store(RingState::free, std::memory_order_release);
+                idleFlushes[ringNo] = 0;
+            }
+        }
+
+        stream->flush();
+    }
+
+    /**
+    * Writes the events recorded on a ring since the last time it was drained
+    * @return The number of events written
+    */
+    juce::uint32 drain(Ring& ring)
+    {
+        auto read = ring.readIndex.load(std::memory_order_relaxed);
+        const auto write = ring.writeIndex.load(std::memory_order_acquire);
+        const auto numEvents = write - read;
+
+        for (; read != write; ++read)
+        {
+            const auto& event = ring.events[read % Ring::capacity];
+            const auto micros = juce::Time::highResolutionTicksToSeconds(event.ticks) * 1.0e6;
+
+            *stream << "{\"name\":\"" << event.name
+                    << "\",\"ph\":\"" << juce::String::charToString(event.phase)
+                    << "\",\"ts\":" << juce::String(micros, 3)
+                    << ",\"pid\":1,\"tid\":" << juce::String(ring.threadId.load(std::memory_order_relaxed))
+                    << (event.phase == 'i' ? ",\"s\":\"t\"" : "")
+                    << ",\"args\":{\"instance\":\"" << juce::String::toHexString(juce::pointer_sized_int(event.instance))
+                    << "\"}},\n";
+        }
+
+        ring.readIndex.store(write, std::memory_order_release);
+        return numEvents;
+    }
+};
+
+//==============================================================================
+Trace::Session::Session()
+    : writer(std::make_unique<Writer>())
+{
+}
+
+Trace::Session::~Session()
+{
+}
+
+#endif
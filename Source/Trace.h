@@ -0,0 +1,84 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Set to 1 in the exporter's preprocessor definitions to record a trace of audio and editor events
+#ifndef COMBINER_ENABLE_TRACING
+ #define COMBINER_ENABLE_TRACING 0
+#endif
+
+#if COMBINER_ENABLE_TRACING
+
+//==============================================================================
+/**
+* Trace
+* Records timestamped events into a ring buffer owned by the calling thread, without locking or
+* allocating, and writes them from a background thread to a Chrome trace event JSON file that can be
+* opened in Perfetto or chrome://tracing alongside a trace of the host.
+* The file is named by the COMBINER_TRACE_FILE environment variable, or Combiner-trace-<time>.json in
+* the temp directory.
+* @author Ryan Logan
+*
+*/
+namespace Trace
+{
+    /**
+    * Records a single event on the calling thread's ring buffer. Events are dropped if the ring is full.
+    * @param name A string literal naming the event
+    * @param phase 'B' to begin a duration, 'E' to end it, or 'i' for an instant
+    * @param instance The plugin instance the event belongs to
+    */
+    void record(const char* name, char phase, const void* instance);
+
+    /**
+    * Keeps the background writer running for as long as any instance holds one
+    */
+    class Session
+    {
+    public:
+        Session();
+        ~Session();
+
+    private:
+        class Writer;
+        std::unique_ptr<Writer> writer;
+
+        JUCE_DECLARE_NON_COPYABLE(Session)
+    };
+
+    /**
+    * Records a duration for as long as it is in scope
+    */
+    class ScopedEvent
+    {
+    public:
+        ScopedEvent(const char* eventName, const void* eventInstance)
+            : name(eventName), instance(eventInstance)
+        {
+            record(name, 'B', instance);
+        }
+
+        ~ScopedEvent()
+        {
+            record(name, 'E', instance);
+        }
+
+    private:
+        const char* name;
+        const void* instance;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+}
+
+ #define COMBINER_TRACE_SESSION juce::SharedResourcePointer<Trace::Session> traceSession;
+ #define COMBINER_TRACE_SCOPE(name) Trace::ScopedEvent JUCE_JOIN_MACRO(traceEvent, __LINE__)(name, this);
+ #define COMBINER_TRACE_INSTANT(name) Trace::record(name, 'i', this);
+
+#else
+
+ #define COMBINER_TRACE_SESSION
+ #define COMBINER_TRACE_SCOPE(name)
+ #define COMBINER_TRACE_INSTANT(name)
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+* The commands CombinerHost can run, each defined in a file of the same name
+*/
+namespace Commands
+{
+    /**
+    * Runs many instances across several threads and reports throughput, cost per instance, scaling and deadline misses
+    */
+    juce::ConsoleApplication::Command getLoadTest();
+
+    /**
+    * Compares renders split across threads with serial renders, sample by sample, and fails if they differ
+    */
+    juce::ConsoleApplication::Command getSegmentTest();
+
+    /**
+    * Changes parameters rapidly from another thread while checking the output for invalid samples, clicks and late blocks
+    */
+    juce::ConsoleApplication::Command getStressTest();
+
+    /**
+    * Changes slope and fails if the crossfade steps further between samples than either slope does on its own
+    */
+    juce::ConsoleApplication::Command getFadeTest();
+
+    /**
+    * Times the spectral engine block by block and fails if any block takes longer than real time allows
+    */
+    juce::ConsoleApplication::Command getSpectralTest();
+
+    /**
+    * Times creating and preparing instances, and opening and closing their editors
+    */
+    juce::ConsoleApplication::Command getInstanceBench();
+}
@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    CoreTest: checks the crossover through both of its interfaces, Crossover
+    and the C functions in CombinerCore.h. Needs nothing but the core library,
+    and returns non-zero if any check fails.
+
+  ==============================================================================
+*/
+
+#include "Crossover.h"
+#include "CombinerCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr double cutoff = 750.0;
+    constexpr int numSamples = 1 << 15;
+
+    // the filter memory decays for this long before any output is compared
+    constexpr int settleLength = 1 << 13;
+
+    int numFailures{ 0 };
+
+    void check(bool passed, const char* description, double measured)
+    {
+        std::printf("%-4s %-60s %g\n", passed ? "ok" : "FAIL", description, measured);
+        if (!passed)
+            ++numFailures;
+    }
+
+    /**
+    * Two channels of audio, as the channel pointers Crossover and the C functions take
+    */
+    struct Stereo
+    {
+        std::vector<float> channels[2];
+        float* pointers[2]{};
+
+        Stereo()
+        {
+            for (auto& channel : channels)
+                channel.assign(numSamples, 0.0f);
+            pointTo();
+        }
+
+        Stereo(const Stereo& other)
+        {
+            for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+                channels[channelNo] = other.channels[channelNo];
+            pointTo();
+        }
+
+        Stereo& operator=(const Stereo&) = delete;
+
+        void pointTo()
+        {
+            for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+                pointers[channelNo] = channels[channelNo].data();
+        }
+
+        AudioSpan getSpan() { return { pointers, 2, numSamples }; }
+    };
+
+    Stereo createNoise(unsigned int seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        Stereo stereo;
+        for (auto& channel : stereo.channels)
+            for (auto& sample : channel)
+                sample = noise(random);
+        return stereo;
+    }
+
+    /**
+    * Where both filters share a cutoff on the 12 and 24 dB/8ve slopes, the two bands split() writes must add up to
+    * an allpass: a sine at any frequency comes out of the sum with the power it went in with
+    */
+    void checkSplitSumsToAllpass(int slope)
+    {
+        double worstGain{ 0.0 };
+        // whole numbers of cycles over the samples measured, so the power of a unit sine is exactly 0.5.
+        // At 48 kHz these are about 50 Hz, 300 Hz, the cutoff, 2 kHz and 15 kHz
+        for (double cycles : { 26.0, 154.0, 384.0, 1024.0, 7680.0 })
+        {
+            Crossover crossover;
+            crossover.setSlope(slope);
+            crossover.setCutoffs(cutoff, cutoff);
+            crossover.prepare(sampleRate);
+
+            Stereo input, hipass;
+            for (auto& channel : input.channels)
+                for (int sampleNo{ 0 }; sampleNo < numSamples; ++sampleNo)
+                    channel[sampleNo] = float(std::sin(2.0 * 3.141592653589793 * cycles * sampleNo / double(numSamples - settleLength)));
+
+            crossover.split(input.getSpan(), hipass.getSpan());
+
+            // the input is overwritten with the lopass band, so its power is that of a unit sine
+            double power{ 0.0 };
+            for (int sampleNo{ settleLength }; sampleNo < numSamples; ++sampleNo)
+                power += std::pow(double(input.channels[0][sampleNo]) + double(hipass.channels[0][sampleNo]), 2.0);
+            power /= double(numSamples - settleLength);
+            worstGain = std::max(worstGain, std::abs(std::sqrt(2.0 * power) - 1.0));
+        }
+
+        char description[128];
+        std::snprintf(description, sizeof(description), "slope %d: split bands sum to an allpass (gain error)", slope);
+        check(worstGain < 1.0e-4, description, worstGain);
+    }
+
+    /**
+    * combine() with the same input on both sides must give what split() followed by summing the bands gives,
+    * whether or not split() derives the hipass from the allpass
+    */
+    void checkCombineMatchesSplit(int slope, bool offline)
+    {
+        Crossover combiner, splitter;
+        for (auto* crossover : { &combiner, &splitter })
+        {
+            crossover->setSlope(slope);
+            crossover->setCutoffs(cutoff, cutoff);
+            crossover->prepare(sampleRate);
+            crossover->setOffline(offline);
+        }
+
+        auto lopass = createNoise(1);
+        auto hipass = lopass;
+        auto split = lopass;
+        Stereo splitHipass;
+
+        combiner.combine(lopass.getSpan(), hipass.getSpan());
+        splitter.split(split.getSpan(), splitHipass.getSpan());
+
+        double worstError{ 0.0 };
+        for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+            for (int sampleNo{ 0 }; sampleNo < numSamples; ++sampleNo)
+                worstError = std::max(worstError, std::abs(double(lopass.channels[channelNo][sampleNo])
+                    - (double(split.channels[channelNo][sampleNo]) + double(splitHipass.channels[channelNo][sampleNo]))));
+
+        char description[128];
+        std::snprintf(description, sizeof(description), "slope %d%s: combine() matches split() then sum", slope, offline ? " offline" : "");
+        check(worstError < 1.0e-5, description, worstError);
+    }
+
+    /**
+    * The last two lanes of the kernel run the hipass for combine() and the allpass for split(). After switching from
+    * one to the other, those lanes must start from silence, exactly as on a crossover that never ran the other set
+    */
+    void checkCoefficientSwitchClearsHipassLanes(int slope)
+    {
+        Crossover switched, fresh;
+        for (auto* crossover : { &switched, &fresh })
+        {
+            crossover->setSlope(slope);
+            crossover->setCutoffs(cutoff, cutoff);
+            crossover->prepare(sampleRate);
+        }
+
+        auto lopass = createNoise(3), allpass = createNoise(4);
+        float* splitLanes[kernelLanes]{ lopass.pointers[0], lopass.pointers[1], allpass.pointers[0], allpass.pointers[1] };
+        switched.process(splitLanes, numSamples, true, false);
+
+        auto switchedLopass = createNoise(5), switchedHipass = createNoise(6);
+        auto freshLopass = switchedLopass, freshHipass = switchedHipass;
+        float* switchedLanes[kernelLanes]{ switchedLopass.pointers[0], switchedLopass.pointers[1], switchedHipass.pointers[0], switchedHipass.pointers[1] };
+        float* freshLanes[kernelLanes]{ freshLopass.pointers[0], freshLopass.pointers[1], freshHipass.pointers[0], freshHipass.pointers[1] };
+        switched.process(switchedLanes, numSamples, false, false);
+        fresh.process(freshLanes, numSamples, false, false);
+
+        const bool identical = switchedHipass.channels[0] == freshHipass.channels[0] && switchedHipass.channels[1] == freshHipass.channels[1];
+        char description[128];
+        std::snprintf(description, sizeof(description), "slope %d: hipass lanes restart after the allpass ran", slope);
+        check(identical, description, identical ? 0.0 : 1.0);
+    }
+
+    /**
+    * Filters a block of full scale DC through the C interface, changes the filters, then filters silence
+    * @return The loudest sample of the silence, which is 0 only if the change cleared the memory
+    */
+    double getOutputAfterChange(int newSlope, double newCutoff)
+    {
+        auto* crossover = combiner_create(sampleRate);
+        combiner_set_filters(crossover, cutoff, cutoff, 1);
+
+        Stereo lopass, hipass;
+        for (auto* stereo : { &lopass, &hipass })
+            for (auto& channel : stereo->channels)
+                std::fill(channel.begin(), channel.end(), 1.0f);
+        combiner_combine(crossover, lopass.pointers, hipass.pointers, 2, 64);
+
+        combiner_set_filters(crossover, newCutoff, newCutoff, newSlope);
+        for (auto* stereo : { &lopass, &hipass })
+            for (auto& channel : stereo->channels)
+                std::fill(channel.begin(), channel.end(), 0.0f);
+        combiner_combine(crossover, lopass.pointers, hipass.pointers, 2, 64);
+        combiner_destroy(crossover);
+
+        double peak{ 0.0 };
+        for (auto& channel : lopass.channels)
+            for (int sampleNo{ 0 }; sampleNo < 64; ++sampleNo)
+                peak = std::max(peak, std::abs(double(channel[sampleNo])));
+        return peak;
+    }
+
+    void checkSlopeChangeClearsMemory()
+    {
+        const double afterSlopeChange = getOutputAfterChange(0, cutoff);
+        check(afterSlopeChange == 0.0, "C: combiner_set_filters() clears memory on a slope change", afterSlopeChange);
+
+        const double afterCutoffChange = getOutputAfterChange(1, 1000.0);
+        check(afterCutoffChange > 0.0, "C: combiner_set_filters() keeps memory on a cutoff change", afterCutoffChange);
+    }
+
+    void checkNullIsRejected()
+    {
+        // none of these may crash
+        combiner_destroy(nullptr);
+        combiner_set_filters(nullptr, cutoff, cutoff, 1);
+        combiner_set_offline(nullptr, 1);
+        combiner_reset(nullptr);
+
+        auto noise = createNoise(2);
+        const auto original = noise;
+        combiner_combine(nullptr, noise.pointers, noise.pointers, 2, numSamples);
+        combiner_split(nullptr, noise.pointers, noise.pointers, 2, numSamples);
+
+        auto* crossover = combiner_create(sampleRate);
+        combiner_combine(crossover, nullptr, noise.pointers, 2, numSamples);
+        combiner_combine(crossover, noise.pointers, nullptr, 2, numSamples);
+        combiner_split(crossover, nullptr, noise.pointers, 2, numSamples);
+        combiner_split(crossover, noise.pointers, nullptr, 2, numSamples);
+        combiner_destroy(crossover);
+
+        const bool unchanged = noise.channels[0] == original.channels[0] && noise.channels[1] == original.channels[1];
+        check(unchanged, "C: NULL crossovers and buffers are ignored", unchanged ? 0.0 : 1.0);
+    }
+}
+
+int main()
+{
+    for (int slope{ 0 }; slope < 2; ++slope)
+        checkSplitSumsToAllpass(slope);
+
+    for (int slope{ 0 }; slope < 3; ++slope)
+        for (bool offline : { false, true })
+            checkCombineMatchesSplit(slope, offline);
+
+    for (int slope{ 0 }; slope < 2; ++slope)
+        checkCoefficientSwitchClearsHipassLanes(slope);
+
+    checkSlopeChangeClearsMemory();
+    checkNullIsRejected();
+
+    std::printf("\n%d failed\n", numFailures);
+    return numFailures == 0 ? 0 : 1;
+}
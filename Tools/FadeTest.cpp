@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    Checks that the crossfade between slopes is smooth: the output may step
+    no further from one sample to the next during the fade than it does at
+    either slope on its own.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+#include "HeadlessHost.h"
+#include <iostream>
+
+namespace
+{
+    // steps are measured over windows this long, which covers the 20 ms crossfade with room to spare
+    constexpr double windowSeconds = 0.05;
+
+    /**
+    * Follows the largest step between consecutive samples of any output channel, across block boundaries
+    */
+    struct StepMeter
+    {
+        float lastSample[4]{};
+        float largestStep{ 0.0f };
+
+        void measure(const juce::AudioBuffer<float>& buffer, int numChannels)
+        {
+            for (int channelNo{ 0 }; channelNo < juce::jmin(numChannels, juce::numElementsInArray(lastSample)); ++channelNo)
+            {
+                const auto* samples = buffer.getReadPointer(channelNo);
+                for (int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
+                {
+                    largestStep = juce::jmax(largestStep, std::abs(samples[sampleNo] - lastSample[channelNo]));
+                    lastSample[channelNo] = samples[sampleNo];
+                }
+            }
+        }
+    };
+
+    /**
+    * Plays sines at one slope, changes to another, and measures the largest output step before, during and after the fade
+    * @return The largest step during the fade as a multiple of the larger of the steps before and after it
+    */
+    double measureFade(HeadlessHost::Settings settings, int fromSlope, int toSlope)
+    {
+        settings.slope = fromSlope;
+        auto processor = HeadlessHost::createInstance(settings);
+        auto buffer = HeadlessHost::createBuffer(*processor, settings.blockSize);
+        juce::MidiBuffer midi;
+        const int numOutputs = processor->getTotalNumOutputChannels();
+        const int windowBlocks = juce::jmax(1, int(std::ceil(windowSeconds * settings.sampleRate / settings.blockSize)));
+
+        StepMeter meter;
+        juce::int64 phase{ 0 };
+        auto play = [&](int numBlocks)
+        {
+            meter.largestStep = 0.0f;
+            for (int blockNo{ 0 }; blockNo < numBlocks; ++blockNo)
+            {
+                HeadlessHost::fillWithSines(buffer, settings.sampleRate, phase);
+                processor->processBlock(buffer, midi);
+                meter.measure(buffer, numOutputs);
+            }
+            return meter.largestStep;
+        };
+
+        // the filters start from silence, so each slope settles before it is measured
+        play(4 * windowBlocks);
+        const float before = play(windowBlocks);
+        HeadlessHost::setParameter(*processor, SLOPE_ID, float(toSlope));
+        const float during = play(windowBlocks);
+        play(4 * windowBlocks);
+        const float after = play(windowBlocks);
+
+        return double(during) / double(juce::jmax(before, after, 1.0e-6f));
+    }
+
+    void runFadeTest(const juce::ArgumentList& args)
+    {
+        const auto settings = HeadlessHost::readSettings(args);
+        const double maxRatio = HeadlessHost::getDoubleOption(args, "--max-ratio", 1.05);
+
+        std::cout << "Largest output step during a change of slope, relative to the largest step at either slope" << std::endl
+                  << std::endl
+                  << "    from        to      lanes       ratio" << std::endl;
+
+        bool passed{ true };
+        for (bool split : { false, true })
+        {
+            for (int fromSlope{ 0 }; fromSlope < slopes.size(); ++fromSlope)
+            {
+                for (int toSlope{ 0 }; toSlope < slopes.size(); ++toSlope)
+                {
+                    if (toSlope == fromSlope)
+                        continue;
+
+                    auto layout = settings;
+                    layout.split = split;
+                    const double ratio = measureFade(layout, fromSlope, toSlope);
+                    passed = passed && ratio <= maxRatio;
+
+                    std::cout << slopes[fromSlope].paddedLeft(' ', 8)
+                              << slopes[toSlope].paddedLeft(' ', 10)
+                              << juce::String(split ? "split" : "combine").paddedLeft(' ', 11)
+                              << juce::String(ratio, 3).paddedLeft(' ', 12) << std::endl;
+                }
+            }
+        }
+
+        if (!passed)
+            juce::ConsoleApplication::fail("A crossfade stepped more than " + juce::String(maxRatio, 2)
+                                           + " times as far as either slope on its own");
+    }
+}
+
+juce::ConsoleApplication::Command Commands::getFadeTest()
+{
+    return { "fade",
+             "fade [--max-ratio=<r>] [settings]",
+             "Checks that changes of slope crossfade without a step in the output",
+             "Plays two sines through an instance, changes the slope, and compares the largest step between consecutive\n"
+             "output samples during the crossfade with the largest step once settled at the old and at the new slope.\n"
+             "Runs every change of slope, both combining and splitting. The --slope and --split settings are ignored.\n"
+             "Fails if any fade steps further than the limit allows.\n"
+             "  --max-ratio=<r>        largest fade step allowed, as a multiple of the steady steps, default 1.05\n"
+             + HeadlessHost::getSettingsHelp(),
+             runFadeTest };
+}
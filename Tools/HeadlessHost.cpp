@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    Creates and drives instances of the plugin processor without a host.
+
+  ==============================================================================
+*/
+
+#include "HeadlessHost.h"
+
+HeadlessHost::Settings HeadlessHost::readSettings(const juce::ArgumentList& args)
+{
+    Settings settings;
+    settings.sampleRate = getDoubleOption(args, "--rate", settings.sampleRate);
+    settings.blockSize = juce::jmax(1, getIntOption(args, "--block", settings.blockSize));
+    settings.slope = juce::jlimit(0, slopes.size() - 1, getIntOption(args, "--slope", settings.slope));
+    settings.lopass = float(getDoubleOption(args, "--lopass", settings.lopass));
+    settings.hipass = float(getDoubleOption(args, "--hipass", settings.lopass));
+    settings.split = args.containsOption("--split");
+
+    if (args.containsOption("--engine"))
+    {
+        const int index = engines.indexOf(args.getValueForOption("--engine"), true);
+        if (index < 0)
+            juce::ConsoleApplication::fail("Unknown engine: " + args.getValueForOption("--engine"));
+        settings.engine = static_cast<Engine>(index);
+    }
+
+    return settings;
+}
+
+juce::String HeadlessHost::getSettingsHelp()
+{
+    return "  --rate=<Hz>          sample rate, default 48000\n"
+           "  --block=<samples>    block size, default 256\n"
+           "  --slope=<0|1|2>      12, 24 or 48 dB/8ve, default 1\n"
+           "  --engine=<name>      classic, modulated or spectral, default classic\n"
+           "  --lopass=<Hz>        low-pass cutoff, default 750\n"
+           "  --hipass=<Hz>        high-pass cutoff, default the low-pass cutoff\n"
+           "  --split              split the first input onto two outputs instead of combining two inputs\n";
+}
+
+std::unique_ptr<CombinerAudioProcessor> HeadlessHost::createInstance(const Settings& settings)
+{
+    auto processor = std::make_unique<CombinerAudioProcessor>();
+
+    if (settings.split)
+    {
+        auto layout = processor->getBusesLayout();
+        layout.inputBuses.getReference(1) = juce::AudioChannelSet::disabled();
+        layout.outputBuses.getReference(1) = juce::AudioChannelSet::stereo();
+        if (!processor->setBusesLayout(layout))
+            juce::ConsoleApplication::fail("The processor rejected the splitter layout");
+    }
+
+    setParameter(*processor, LINKED_ID, settings.lopass == settings.hipass ? 1.0f : 0.0f);
+    setParameter(*processor, SLOPE_ID, float(settings.slope));
+    setParameter(*processor, LOPASS_FREQ_ID, settings.lopass);
+    setParameter(*processor, HIPASS_FREQ_ID, settings.hipass);
+    setParameter(*processor, ENGINE_ID, float(static_cast<int>(settings.engine)));
+
+    processor->setRateAndBufferSizeDetails(settings.sampleRate, settings.blockSize);
+    processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+    return processor;
+}
+
+void HeadlessHost::setParameter(CombinerAudioProcessor& processor, const juce::String& parameterID, float value)
+{
+    auto* parameter = processor.parameters.getParameter(parameterID);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+juce::AudioBuffer<float> HeadlessHost::createBuffer(const CombinerAudioProcessor& processor, int numSamples)
+{
+    const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, numSamples);
+    buffer.clear();
+    return buffer;
+}
+
+void HeadlessHost::fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+{
+    for (int channelNo{ 0 }; channelNo < buffer.getNumChannels(); ++channelNo)
+    {
+        auto* samples = buffer.getWritePointer(channelNo);
+        for (int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
+            samples[sampleNo] = random.nextFloat() - 0.5f;
+    }
+}
+
+void HeadlessHost::fillWithSines(juce::AudioBuffer<float>& buffer, double sampleRate, juce::int64& phase)
+{
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+
+    for (int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
+    {
+        const double t = double(phase + sampleNo) / sampleRate;
+        const float sample = float(0.25 * std::sin(twoPi * 220.0 * t) + 0.25 * std::sin(twoPi * 3000.0 * t));
+        for (int channelNo{ 0 }; channelNo < buffer.getNumChannels(); ++channelNo)
+            buffer.setSample(channelNo, sampleNo, sample);
+    }
+
+    phase += buffer.getNumSamples();
+}
+
+int HeadlessHost::getIntOption(const juce::ArgumentList& args, juce::StringRef option, int defaultValue)
+{
+    return args.containsOption(option) ? args.getValueForOption(option).getIntValue() : defaultValue;
+}
+
+double HeadlessHost::getDoubleOption(const juce::ArgumentList& args, juce::StringRef option, double defaultValue)
+{
+    return args.containsOption(option) ? args.getValueForOption(option).getDoubleValue() : defaultValue;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+* HeadlessHost
+* Creates and drives instances of the plugin processor the way a host would, for the commands of CombinerHost.
+* @author Ryan Logan
+*
+*/
+namespace HeadlessHost
+{
+    /**
+    * How each instance is set up, read from the command line
+    */
+    struct Settings
+    {
+        double sampleRate{ 48000.0 };
+        int blockSize{ 256 };
+        int slope{ 1 };
+        Engine engine{ Engine::classic };
+        float lopass{ 750.0f };
+        float hipass{ 750.0f };
+        bool split{ false };
+    };
+
+    /**
+    * Reads --rate, --block, --slope, --engine, --lopass, --hipass and --split, keeping the defaults for any that are missing
+    * @param args The arguments of the command
+    * @return The settings to create instances with
+    */
+    Settings readSettings(const juce::ArgumentList& args);
+
+    /**
+    * @return A description of the options read by readSettings(), for the help text of each command
+    */
+    juce::String getSettingsHelp();
+
+    /**
+    * Creates an instance, sets its parameters and buses, and calls prepareToPlay()
+    * @param settings How to set up the instance
+    * @return The prepared instance
+    */
+    std::unique_ptr<CombinerAudioProcessor> createInstance(const Settings& settings);
+
+    /**
+    * Sets a parameter as a host would, from any thread
+    * @param processor The instance to change
+    * @param parameterID The parameter to change
+    * @param value The new value, in the units of the parameter
+    */
+    void setParameter(CombinerAudioProcessor& processor, const juce::String& parameterID, float value);
+
+    /**
+    * @param processor A prepared instance
+    * @return A buffer with as many channels as processBlock() expects for the instance's buses
+    */
+    juce::AudioBuffer<float> createBuffer(const CombinerAudioProcessor& processor, int numSamples);
+
+    /**
+    * Fills every channel of a buffer with white noise at -6 dBFS
+    */
+    void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random);
+
+    /**
+    * Fills every channel with a 220 Hz and a 3 kHz sine at -12 dBFS each, whose steps are small enough that a click
+    * from the filters stands out
+    * @param phase The sample the block starts at, advanced by the length of the block
+    */
+    void fillWithSines(juce::AudioBuffer<float>& buffer, double sampleRate, juce::int64& phase);
+
+    /**
+    * Reads a numeric option of the form --name=value
+    * @return The value, or defaultValue if the option is missing
+    */
+    int getIntOption(const juce::ArgumentList& args, juce::StringRef option, int defaultValue);
+    double getDoubleOption(const juce::ArgumentList& args, juce::StringRef option, double defaultValue);
+}
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    Times what a host waits for when it loads a session: creating and
+    preparing each instance, opening its editor, and tearing both down.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+#include "HeadlessHost.h"
+#include <iostream>
+
+namespace
+{
+    /**
+    * Milliseconds taken by the first of a series of calls, and by the rest on average
+    */
+    struct Timing
+    {
+        double first{ 0.0 };
+        double total{ 0.0 };
+        int count{ 0 };
+
+        void add(juce::int64 startTicks)
+        {
+            const double millis = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+            if (count++ == 0)
+                first = millis;
+            else
+                total += millis;
+        }
+
+        double getMeanOfRest() const { return count > 1 ? total / double(count - 1) : 0.0; }
+    };
+
+    void printTiming(const juce::String& name, const Timing& timing)
+    {
+        std::cout << name.paddedRight(' ', 20)
+                  << juce::String(timing.first, 3).paddedLeft(' ', 12)
+                  << juce::String(timing.getMeanOfRest(), 3).paddedLeft(' ', 12) << std::endl;
+    }
+
+    void runInstanceBench(const juce::ArgumentList& args)
+    {
+        const auto settings = HeadlessHost::readSettings(args);
+        const int numInstances = juce::jmax(2, HeadlessHost::getIntOption(args, "--instances", 32));
+
+        juce::OwnedArray<CombinerAudioProcessor> instances;
+        juce::OwnedArray<juce::AudioProcessorEditor> editors;
+        Timing create, open, close, destroy;
+
+        // the first instance also pays for anything shared across the process, such as choosing the kernel
+        for (int instanceNo{ 0 }; instanceNo < numInstances; ++instanceNo)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            instances.add(HeadlessHost::createInstance(settings).release());
+            create.add(start);
+        }
+
+        for (auto* instance : instances)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            editors.add(instance->createEditorIfNeeded());
+            open.add(start);
+        }
+
+        // editors must go before their processors, as a host closes them
+        while (!editors.isEmpty())
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            editors.removeLast();
+            close.add(start);
+        }
+
+        while (!instances.isEmpty())
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            instances.removeLast();
+            destroy.add(start);
+        }
+
+        std::cout << numInstances << " instances at " << settings.sampleRate << " Hz, " << settings.blockSize << " sample blocks" << std::endl
+                  << std::endl
+                  << "ms                        first     mean of rest" << std::endl;
+        printTiming("create and prepare", create);
+        printTiming("open editor", open);
+        printTiming("close editor", close);
+        printTiming("destroy", destroy);
+    }
+}
+
+juce::ConsoleApplication::Command Commands::getInstanceBench()
+{
+    return { "instances",
+             "instances [--instances=<n>] [settings]",
+             "Times creating instances and opening their editors",
+             "Creates and prepares the instances one after another, opens an editor on each, then closes the editors\n"
+             "and destroys the instances, as a host loading and closing a session would. Reports the time taken by\n"
+             "the first of each, which includes setting up anything shared across the process, and the mean of the rest.\n"
+             "  --instances=<n>      number of instances, default 32\n"
+             + HeadlessHost::getSettingsHelp(),
+             runInstanceBench };
+}
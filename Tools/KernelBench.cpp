@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    KernelBench: times every build of the filter kernel that this machine
+    supports, at every slope, in both its realtime and its block form, to
+    check which one FilterKernels::select() should prefer and where the
+    block form is worth using. Needs nothing but the core library.
+
+  ==============================================================================
+*/
+
+#include "Crossover.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples = 1 << 18;
+    constexpr int numRuns = 5;
+
+    /**
+    * Combines two stereo buffers of noise a tile at a time
+    * @param offline True to time the block form of the kernel, as the segmented renderer runs it
+    * @return The best of several runs, in millions of samples per channel per second
+    */
+    double measure(KernelType type, int slope, bool offline)
+    {
+        Crossover crossover;
+        crossover.setKernel(type);
+        crossover.setOffline(offline, offline);
+        crossover.setSlope(slope);
+        crossover.setCutoffs(750.0, 750.0);
+        crossover.prepare(sampleRate);
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        std::vector<float> source(numSamples);
+        for (auto& sample : source)
+            sample = noise(random);
+
+        std::vector<float> channels[kernelLanes];
+        float* lopass[2]{};
+        float* hipass[2]{};
+        for (int lane{ 0 }; lane < kernelLanes; ++lane)
+            channels[lane].resize(numSamples);
+        for (int channelNo{ 0 }; channelNo < 2; ++channelNo)
+        {
+            lopass[channelNo] = channels[channelNo].data();
+            hipass[channelNo] = channels[channelNo + 2].data();
+        }
+
+        double bestSeconds{ 1.0e9 };
+        for (int run{ 0 }; run < numRuns; ++run)
+        {
+            for (auto& channel : channels)
+                std::copy(source.begin(), source.end(), channel.begin());
+
+            const auto start = std::chrono::steady_clock::now();
+            crossover.combine({ lopass, 2, numSamples }, { hipass, 2, numSamples });
+            bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return numSamples / bestSeconds / 1.0e6;
+    }
+}
+
+int main()
+{
+    std::printf("Msamples/s per channel, combining two stereo inputs at %.0f Hz. Automatic choice: %s\n\n",
+                sampleRate, FilterKernels::getName(FilterKernels::select().type));
+    std::printf("%-16s%12s%12s%12s\n", "kernel", "12 dB/8ve", "24 dB/8ve", "48 dB/8ve");
+
+    for (auto type : { KernelType::generic, KernelType::sse2, KernelType::avx2, KernelType::avx512, KernelType::neon })
+    {
+        if (!FilterKernels::isSupported(type))
+            continue;
+
+        for (bool offline : { false, true })
+        {
+            std::printf("%-8s%-8s", FilterKernels::getName(type), offline ? "block" : "");
+            for (int slope{ 0 }; slope < 3; ++slope)
+                std::printf("%12.1f", measure(type, slope, offline));
+            std::printf("\n");
+        }
+    }
+
+    // the choice Crossover makes offline when blocks are not split across threads
+    std::printf("\n%-16s", "offline uses");
+    for (int slope{ 0 }; slope < 3; ++slope)
+    {
+        Crossover crossover;
+        crossover.setSlope(slope);
+        crossover.prepare(sampleRate);
+        crossover.setOffline(true);
+        std::printf("%12s", crossover.usesOfflineKernel() ? "block" : "realtime");
+    }
+    std::printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    Runs many instances of the processor over several threads, as a host with
+    a multi-threaded audio engine would, and reports what they cost.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+#include "HeadlessHost.h"
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    /**
+    * An instance with buffers of its own, so every instance touches its own memory as it would in a host
+    */
+    struct Instance
+    {
+        Instance(const HeadlessHost::Settings& settings, int instanceNo)
+            : processor(HeadlessHost::createInstance(settings)),
+              input(HeadlessHost::createBuffer(*processor, settings.blockSize)),
+              buffer(HeadlessHost::createBuffer(*processor, settings.blockSize))
+        {
+            juce::Random random(instanceNo);
+            HeadlessHost::fillWithNoise(input, random);
+        }
+
+        void processBlock()
+        {
+            buffer.makeCopyOf(input, true);
+            processor->processBlock(buffer, midi);
+        }
+
+        std::unique_ptr<CombinerAudioProcessor> processor;
+        juce::AudioBuffer<float> input, buffer;
+        juce::MidiBuffer midi;
+    };
+
+    /**
+    * The results of running some of the instances with a given number of threads
+    */
+    struct Round
+    {
+        int numInstances{ 0 };
+        int numThreads{ 0 };
+        double wallSeconds{ 0.0 };
+        juce::uint64 cycleMisses{ 0 };
+        ProcessLoadMonitor::ProcessStatistics load;
+    };
+
+    /**
+    * Processes the first numInstances instances, spread over numThreads threads
+    */
+    Round runRound(juce::OwnedArray<Instance>& instances, const HeadlessHost::Settings& settings,
+                   int numInstances, int numThreads, int numBlocks)
+    {
+        for (auto* instance : instances)
+            instance->processor->getLoadMonitor().resetStatistics();
+
+        const double blockSeconds = settings.blockSize / settings.sampleRate;
+        std::atomic<juce::uint64> cycleMisses{ 0 };
+        std::vector<std::thread> threads;
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        // each thread takes every numThreads'th instance, and processes one block of each in turn as fast as it can.
+        // A cycle through all of a thread's instances that takes longer than a block lasts would have glitched in a host
+        for (int threadNo{ 0 }; threadNo < numThreads; ++threadNo)
+        {
+            threads.emplace_back([&, threadNo]
+            {
+                juce::uint64 misses{ 0 };
+
+                for (int blockNo{ 0 }; blockNo < numBlocks; ++blockNo)
+                {
+                    const auto cycleStart = juce::Time::getHighResolutionTicks();
+                    for (int instanceNo{ threadNo }; instanceNo < numInstances; instanceNo += numThreads)
+                        instances[instanceNo]->processBlock();
+
+                    if (juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - cycleStart) > blockSeconds)
+                        ++misses;
+                }
+
+                cycleMisses += misses;
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        Round round;
+        round.numInstances = numInstances;
+        round.numThreads = numThreads;
+        round.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        round.cycleMisses = cycleMisses;
+        round.load = ProcessLoadMonitor::getProcessStatistics();
+        return round;
+    }
+
+    double getMicrosPerBlock(const Round& round)
+    {
+        const auto& total = round.load.total;
+        return total.numBlocks > 0 ? total.totalSeconds * 1.0e6 / double(total.numBlocks) : 0.0;
+    }
+
+    /**
+    * @param scaling The round's throughput or cost relative to the first round, 1 where it scales perfectly
+    */
+    void printRound(const Round& round, double scaling, double sampleRate)
+    {
+        // how many instances could run in real time at this rate of processing
+        const double realtimeInstances = double(round.load.total.numSamples) / sampleRate / round.wallSeconds;
+        const auto& total = round.load.total;
+
+        std::cout << juce::String(round.numInstances).paddedLeft(' ', 10)
+                  << juce::String(round.numThreads).paddedLeft(' ', 8)
+                  << juce::String(total.getThroughput() / 1.0e6, 2).paddedLeft(' ', 12)
+                  << juce::String(realtimeInstances, 1).paddedLeft(' ', 12)
+                  << juce::String(getMicrosPerBlock(round), 2).paddedLeft(' ', 14)
+                  << juce::String(total.worstLoad * 100.0, 1).paddedLeft(' ', 12)
+                  << juce::String(total.deadlineMisses).paddedLeft(' ', 12)
+                  << juce::String(round.cycleMisses).paddedLeft(' ', 12)
+                  << juce::String(scaling * 100.0, 0).paddedLeft(' ', 10) << std::endl;
+    }
+
+    void runLoadTest(const juce::ArgumentList& args)
+    {
+        const auto settings = HeadlessHost::readSettings(args);
+        const int numInstances = juce::jmax(1, HeadlessHost::getIntOption(args, "--instances", 16));
+        const int maxThreads = juce::jlimit(1, numInstances, HeadlessHost::getIntOption(args, "--threads", juce::SystemStats::getNumCpus()));
+        const double seconds = HeadlessHost::getDoubleOption(args, "--seconds", 10.0);
+        const int numBlocks = juce::jmax(1, int(seconds * settings.sampleRate / settings.blockSize));
+
+        juce::OwnedArray<Instance> instances;
+        for (int instanceNo{ 0 }; instanceNo < numInstances; ++instanceNo)
+            instances.add(new Instance(settings, instanceNo));
+
+        const juce::String heading = " instances threads  Msamples/s  realtime x  us per block  worst load  late blocks  late cycles   scaling";
+
+        std::cout << numInstances << " instances of the " << engines[static_cast<int>(settings.engine)] << " engine at "
+                  << slopes[settings.slope] << " dB/8ve, " << settings.blockSize << " sample blocks at "
+                  << settings.sampleRate << " Hz, " << seconds << " s of audio each" << std::endl
+                  << std::endl
+                  << "Every instance, on more and more threads. Scaling is the throughput against perfect scaling from one thread" << std::endl
+                  << heading << std::endl;
+
+        // double the threads each round, so the scaling can be read against the first
+        double oneThreadThroughput{ 0.0 };
+        for (int numThreads{ 1 }; ; numThreads = juce::jmin(numThreads * 2, maxThreads))
+        {
+            const auto round = runRound(instances, settings, numInstances, numThreads, numBlocks);
+            const double throughput = double(round.load.total.numSamples) / round.wallSeconds;
+            if (numThreads == 1)
+                oneThreadThroughput = throughput;
+            printRound(round, throughput / (oneThreadThroughput * numThreads), settings.sampleRate);
+
+            if (numThreads == maxThreads)
+                break;
+        }
+
+        std::cout << std::endl
+                  << "More and more instances on " << maxThreads << " threads. Scaling is the cost of a block against the first round,"
+                  << " so a drop shows the instances crowding each other out of the caches" << std::endl
+                  << heading << std::endl;
+
+        // double the instances each round with the threads fixed, so only the memory the instances touch grows.
+        // Threads without an instance of their own sit idle
+        double firstMicrosPerBlock{ 0.0 };
+        for (int numActive{ 1 }; ; numActive = juce::jmin(numActive * 2, numInstances))
+        {
+            const auto round = runRound(instances, settings, numActive, maxThreads, numBlocks);
+            if (numActive == 1)
+                firstMicrosPerBlock = getMicrosPerBlock(round);
+            printRound(round, firstMicrosPerBlock / juce::jmax(getMicrosPerBlock(round), 1.0e-9), settings.sampleRate);
+
+            if (numActive == numInstances)
+                break;
+        }
+    }
+}
+
+juce::ConsoleApplication::Command Commands::getLoadTest()
+{
+    return { "load",
+             "load [--instances=<n>] [--threads=<n>] [--seconds=<s>] [settings]",
+             "Measures the throughput of many instances spread over several threads",
+             "Creates the instances, each with buffers of its own, then processes the same length of noise through all\n"
+             "of them with 1, 2, 4 ... threads, and through 1, 2, 4 ... of them with the most threads. Each thread runs\n"
+             "its share of the instances one block at a time, as a host's audio threads would. For each round it\n"
+             "reports the samples processed per second of processing time, how many instances could run in real time,\n"
+             "the mean cost of one block of one instance, the worst block's share of its real-time budget, the blocks\n"
+             "and the cycles through a thread's instances that took longer than real time, and the scaling: against\n"
+             "perfect scaling from one thread as threads are added, and against the cost of a block of one instance as\n"
+             "instances are added.\n"
+             "  --instances=<n>      number of instances, default 16\n"
+             "  --threads=<n>        most threads to use, default the number of CPUs\n"
+             "  --seconds=<s>        length of audio each instance processes in each round, default 10\n"
+             + HeadlessHost::getSettingsHelp(),
+             runLoadTest };
+}
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    CombinerHost: runs the plugin processor without a host, for measurement
+    and testing. Run with --help for the list of commands.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+
+int main(int argc, char* argv[])
+{
+    // the processor's parameters and the editor expect a message manager, even without a message loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage: CombinerHost <command> [options]", true);
+    app.addCommand(Commands::getLoadTest());
+    app.addCommand(Commands::getSegmentTest());
+    app.addCommand(Commands::getStressTest());
+    app.addCommand(Commands::getFadeTest());
+    app.addCommand(Commands::getSpectralTest());
+    app.addCommand(Commands::getInstanceBench());
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    Counts invalid and discontinuous samples in the output of processBlock.
+
+  ==============================================================================
+*/
+
+#include "OutputHealth.h"
+
+namespace
+{
+    constexpr juce::uint32 exponentMask = 0x7f800000;
+    constexpr juce::uint32 mantissaMask = 0x007fffff;
+
+    // adds to a counter that only the audio thread writes
+    void increment(std::atomic<juce::uint64>& counter, juce::uint64 amount)
+    {
+        if (amount > 0)
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+OutputHealthMonitor::OutputHealthMonitor()
+{
+}
+
+OutputHealthMonitor::~OutputHealthMonitor()
+{
+}
+
+void OutputHealthMonitor::setDiscontinuityThreshold(float ratio, float minimumJump)
+{
+    jumpRatio = ratio;
+    minJump = minimumJump;
+}
+
+void OutputHealthMonitor::beginBlock(const juce::AudioBuffer<float>& buffer, int numInputChannels)
+{
+    inputJump = 0.0f;
+
+    for (int channelNo{ 0 }; channelNo < juce::jmin(numInputChannels, maxChannels); ++channelNo)
+    {
+        const float* samples = buffer.getReadPointer(channelNo);
+        float previous = lastInput[channelNo];
+
+        for (int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
+        {
+            inputJump = juce::jmax(inputJump, std::abs(samples[sampleNo] - previous));
+            previous = samples[sampleNo];
+        }
+
+        lastInput[channelNo] = previous;
+    }
+}
+
+void OutputHealthMonitor::endBlock(const juce::AudioBuffer<float>& buffer, int numOutputChannels)
+{
+    const float threshold = juce::jmax(minJump, jumpRatio * inputJump);
+    juce::uint64 nans{ 0 }, infs{ 0 }, denormals{ 0 }, discontinuities{ 0 };
+    float blockJump{ 0.0f };
+
+    for (int channelNo{ 0 }; channelNo < juce::jmin(numOutputChannels, maxChannels); ++channelNo)
+    {
+        const float* samples = buffer.getReadPointer(channelNo);
+        float previous = lastOutput[channelNo];
+
+        for (int sampleNo{ 0 }; sampleNo < buffer.getNumSamples(); ++sampleNo)
+        {
+            // classify from the bits, as the compiler may assume finite maths for std::isnan
+            juce::uint32 bits;
+            std::memcpy(&bits, samples + sampleNo, sizeof(bits));
+
+            if ((bits & exponentMask) == exponentMask)
+            {
+                if ((bits & mantissaMask) != 0)
+                    ++nans;
+                else
+                    ++infs;
+                continue;
+            }
+
+            if ((bits & exponentMask) == 0 && (bits & mantissaMask) != 0)
+                ++denormals;
+
+            const float jump = std::abs(samples[sampleNo] - previous);
+            blockJump = juce::jmax(blockJump, jump);
+            if (jump > threshold)
+                ++discontinuities;
+            previous = samples[sampleNo];
+        }
+
+        lastOutput[channelNo] = previous;
+    }
+
+    increment(numNaNs, nans);
+    increment(numInfs, infs);
+    increment(numDenormals, denormals);
+    increment(numDiscontinuities, discontinuities);
+    if (blockJump > largestJump.load(std::memory_order_relaxed))
+        largestJump.store(blockJump, std::memory_order_relaxed);
+}
+
+OutputHealthMonitor::Statistics OutputHealthMonitor::getStatistics() const
+{
+    Statistics stats;
+    stats.numNaNs = numNaNs.load(std::memory_order_relaxed);
+    stats.numInfs = numInfs.load(std::memory_order_relaxed);
+    stats.numDenormals = numDenormals.load(std::memory_order_relaxed);
+    stats.numDiscontinuities = numDiscontinuities.load(std::memory_order_relaxed);
+    stats.largestJump = largestJump.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void OutputHealthMonitor::resetStatistics()
+{
+    numNaNs = 0;
+    numInfs = 0;
+    numDenormals = 0;
+    numDiscontinuities = 0;
+    largestJump = 0.0f;
+}
+
+juce::StringArray OutputHealthMonitor::checkBudget(const Budget& budget, const ProcessLoadMonitor::Statistics& load) const
+{
+    const auto stats = getStatistics();
+    juce::StringArray failures;
+
+    if (load.worstLoad > budget.maxWorstLoad)
+        failures.add("worst block used " + juce::String(load.worstLoad * 100.0, 1) + "% of its budget");
+    if (stats.numNaNs + stats.numInfs > budget.maxNonFinite)
+        failures.add(juce::String(stats.numNaNs) + " NaN and " + juce::String(stats.numInfs) + " infinite samples");
+    if (stats.numDenormals > budget.maxDenormals)
+        failures.add(juce::String(stats.numDenormals) + " denormal samples");
+    if (stats.numDiscontinuities > budget.maxDiscontinuities)
+        failures.add(juce::String(stats.numDiscontinuities) + " discontinuities, largest jump " + juce::String(stats.largestJump, 3));
+
+    return failures;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessLoad.h"
+
+//==============================================================================
+/**
+* OutputHealthMonitor
+* Counts the samples processBlock produces that should never reach the host: NaN, infinity,
+* denormals, and jumps far larger than any in the input. Together with the worst block time from
+* ProcessLoadMonitor this makes pops and glitches under fast parameter changes measurable.
+* The stress command of CombinerHost wraps processBlock with it, so the plugin itself pays nothing.
+* @author Ryan Logan
+*
+*/
+class OutputHealthMonitor
+{
+public:
+    /**
+    * Totals since construction or the last call to resetStatistics()
+    */
+    struct Statistics
+    {
+        juce::uint64 numNaNs{ 0 };
+        juce::uint64 numInfs{ 0 };
+        juce::uint64 numDenormals{ 0 };
+        juce::uint64 numDiscontinuities{ 0 };
+        float largestJump{ 0.0f };
+    };
+
+    /**
+    * The most of each kind of fault that can be tolerated
+    */
+    struct Budget
+    {
+        double maxWorstLoad{ 1.0 };
+        juce::uint64 maxNonFinite{ 0 };
+        juce::uint64 maxDenormals{ 0 };
+        juce::uint64 maxDiscontinuities{ 0 };
+    };
+
+    OutputHealthMonitor();
+    ~OutputHealthMonitor();
+
+    /**
+    * Sets how much larger than the largest step in the input an output step must be to count as a discontinuity
+    * @param ratio Output steps up to this multiple of the largest input step are allowed
+    * @param minimumJump Output steps smaller than this are never counted, e.g. for silent input
+    */
+    void setDiscontinuityThreshold(float ratio, float minimumJump);
+
+    /**
+    * Measures the input before it is processed. Called from the audio thread.
+    * @param buffer The buffer passed to processBlock()
+    * @param numInputChannels The number of channels holding input
+    */
+    void beginBlock(const juce::AudioBuffer<float>& buffer, int numInputChannels);
+
+    /**
+    * Checks the output once it has been processed. Called from the audio thread.
+    * @param buffer The buffer passed to processBlock()
+    * @param numOutputChannels The number of channels holding output
+    */
+    void endBlock(const juce::AudioBuffer<float>& buffer, int numOutputChannels);
+
+    /**
+    * Reads the totals. Safe to call from any thread.
+    */
+    Statistics getStatistics() const;
+
+    /**
+    * Clears the totals
+    */
+    void resetStatistics();
+
+    /**
+    * Compares the totals against a budget
+    * @param budget The faults that can be tolerated
+    * @param load The timing of the same blocks, from ProcessLoadMonitor
+    * @return A description of each way the budget was exceeded, empty if it was met
+    */
+    juce::StringArray checkBudget(const Budget& budget, const ProcessLoadMonitor::Statistics& load) const;
+
+private:
+    static constexpr int maxChannels = 4;
+
+    float jumpRatio{ 4.0f };
+    float minJump{ 0.5f };
+
+    // largest step between consecutive input samples in the current block
+    float inputJump{ 0.0f };
+
+    // last sample of the previous block, so jumps across a block boundary are caught
+    float lastInput[maxChannels]{};
+    float lastOutput[maxChannels]{};
+
+    // only the audio thread writes, other threads read
+    std::atomic<juce::uint64> numNaNs{ 0 }, numInfs{ 0 }, numDenormals{ 0 }, numDiscontinuities{ 0 };
+    std::atomic<float> largestJump{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputHealthMonitor)
+};
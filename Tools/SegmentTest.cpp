@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    Checks that a render split across threads by SegmentedRenderer matches
+    the same render done in one go, sample by sample.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+#include "HeadlessHost.h"
+#include <iostream>
+
+namespace
+{
+    // longer than several segments at the lowest cutoff, whose pre-roll is the longest
+    constexpr int renderLength = 1 << 19;
+
+    // a block rendered serially after each render, to check the memory the segmented render leaves behind
+    constexpr int followUpLength = 4096;
+
+    // noise peaks at 0.5, so this is about -74 dB below it
+    constexpr double maxError = 1.0e-4;
+
+    /**
+    * Lanes of audio for the kernel
+    */
+    struct Lanes
+    {
+        Lanes(int numSamples) : buffer(kernelLanes, numSamples) {}
+
+        juce::AudioBuffer<float> buffer;
+        float* const* get() { return buffer.getArrayOfWritePointers(); }
+    };
+
+    /**
+    * @return The largest difference between the first numLanes lanes of two buffers
+    */
+    double getLargestDifference(const juce::AudioBuffer<float>& expected, const juce::AudioBuffer<float>& actual, int numLanes)
+    {
+        double difference{ 0.0 };
+        for (int lane{ 0 }; lane < numLanes; ++lane)
+            for (int sampleNo{ 0 }; sampleNo < expected.getNumSamples(); ++sampleNo)
+                difference = juce::jmax(difference, double(std::abs(expected.getSample(lane, sampleNo) - actual.getSample(lane, sampleNo))));
+        return difference;
+    }
+
+    /**
+    * Renders the same noise serially and segmented, then a follow-up block from the memory each left behind
+    * @param sumPairs True for the lanes and sum combine() uses, false for those split() uses
+    * @return False if the renderer would not split the buffer
+    */
+    bool compare(SegmentedRenderer& renderer, int slope, double cutoff, bool sumPairs, double& renderError, double& followUpError)
+    {
+        Crossover crossover;
+        crossover.setSlope(slope);
+        crossover.setCutoffs(cutoff, cutoff);
+        crossover.prepare(48000.0);
+
+        const auto& kernel = crossover.getKernel();
+        const auto& coefficients = crossover.getOfflineCoefficients(!sumPairs);
+        const int numLanes = sumPairs ? 2 : kernelLanes;
+        juce::Random random(slope * 1000 + int(cutoff));
+
+        Lanes serial(renderLength), segmented(renderLength);
+        HeadlessHost::fillWithNoise(serial.buffer, random);
+        segmented.buffer.makeCopyOf(serial.buffer, true);
+
+        OfflineState serialState{}, segmentedState{};
+        kernel.processOffline(coefficients, serialState, serial.get(), renderLength, sumPairs);
+        if (!renderer.process(kernel, coefficients, segmentedState, segmented.get(), renderLength, sumPairs))
+            return false;
+        renderError = getLargestDifference(serial.buffer, segmented.buffer, numLanes);
+
+        Lanes serialFollowUp(followUpLength), segmentedFollowUp(followUpLength);
+        HeadlessHost::fillWithNoise(serialFollowUp.buffer, random);
+        segmentedFollowUp.buffer.makeCopyOf(serialFollowUp.buffer, true);
+
+        kernel.processOffline(coefficients, serialState, serialFollowUp.get(), followUpLength, sumPairs);
+        kernel.processOffline(coefficients, segmentedState, segmentedFollowUp.get(), followUpLength, sumPairs);
+        followUpError = getLargestDifference(serialFollowUp.buffer, segmentedFollowUp.buffer, numLanes);
+        return true;
+    }
+
+    void runSegmentTest(const juce::ArgumentList&)
+    {
+        SegmentedRenderer renderer;
+        renderer.prepare(renderLength);
+
+        std::cout << "Largest difference from a serial render of " << renderLength << " samples of noise, and of the block after it" << std::endl
+                  << std::endl
+                  << "   slope    cutoff      lanes      render   follow-up" << std::endl;
+
+        bool passed{ true };
+        for (int slope{ 0 }; slope < slopes.size(); ++slope)
+        {
+            for (double cutoff : { 20.0, 750.0, 5000.0 })
+            {
+                for (bool sumPairs : { true, false })
+                {
+                    double renderError{ 0.0 }, followUpError{ 0.0 };
+                    const bool split = compare(renderer, slope, cutoff, sumPairs, renderError, followUpError);
+                    passed = passed && split && renderError <= maxError && followUpError <= maxError;
+
+                    std::cout << slopes[slope].paddedLeft(' ', 8)
+                              << juce::String(cutoff, 0).paddedLeft(' ', 10)
+                              << juce::String(sumPairs ? "combine" : "split").paddedLeft(' ', 11);
+                    if (split)
+                        std::cout << juce::String(renderError, 9).paddedLeft(' ', 12)
+                                  << juce::String(followUpError, 9).paddedLeft(' ', 12) << std::endl;
+                    else
+                        std::cout << "   not split" << std::endl;
+                }
+            }
+        }
+
+        if (!passed)
+            juce::ConsoleApplication::fail("Segmented renders differ from serial renders by more than " + juce::String(maxError));
+    }
+}
+
+juce::ConsoleApplication::Command Commands::getSegmentTest()
+{
+    return { "segments",
+             "segments",
+             "Checks that renders split across threads match serial renders",
+             "Renders noise through the block kernel at every slope and at low, middle and high cutoffs, once in one go\n"
+             "and once split into segments by SegmentedRenderer, and compares every sample of the two. It then renders a\n"
+             "further block from the memory each left behind, to check the memory the segmented render hands back.\n"
+             "Fails if any difference is larger than " + juce::String(maxError) + ".\n",
+             runSegmentTest };
+}
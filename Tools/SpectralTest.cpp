@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    Checks that the spectral engine keeps up with real time: 4096 point
+    frames at 75% overlap on every lane, measured block by block.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+#include "HeadlessHost.h"
+#include <iostream>
+
+namespace
+{
+    void runSpectralTest(const juce::ArgumentList& args)
+    {
+        const auto settings = HeadlessHost::readSettings(args);
+        const double seconds = HeadlessHost::getDoubleOption(args, "--seconds", 10.0);
+        const double maxLoad = HeadlessHost::getDoubleOption(args, "--max-load", 1.0);
+        const int numBlocks = juce::jmax(1, int(seconds * settings.sampleRate / settings.blockSize));
+
+        SpectralCrossover crossover;
+        crossover.prepare(settings.sampleRate);
+        crossover.setCutoffs(settings.lopass, settings.hipass);
+
+        ProcessLoadMonitor monitor;
+        monitor.prepare(settings.sampleRate);
+        monitor.setDeadline(maxLoad);
+
+        juce::Random random(1);
+        juce::AudioBuffer<float> input(kernelLanes, settings.blockSize), buffer(kernelLanes, settings.blockSize);
+        HeadlessHost::fillWithNoise(input, random);
+
+        // the frames fall in whichever blocks complete a hop, so every block is timed and the worst one matters most
+        for (int blockNo{ 0 }; blockNo < numBlocks; ++blockNo)
+        {
+            buffer.makeCopyOf(input, true);
+            ProcessLoadMonitor::ScopedBlock blockTimer(monitor, settings.blockSize);
+            crossover.process(buffer.getArrayOfWritePointers(), settings.blockSize, !settings.split);
+        }
+
+        const auto load = monitor.getStatistics();
+        const double numFrames = double(load.numSamples) / double(SpectralCrossover::hopLength);
+        const double realtime = load.getThroughput() / settings.sampleRate;
+
+        std::cout << SpectralCrossover::fftLength << " point frames every " << SpectralCrossover::hopLength << " samples on "
+                  << kernelLanes << " lanes, " << settings.blockSize << " sample blocks at " << settings.sampleRate << " Hz" << std::endl
+                  << std::endl
+                  << "realtime x    " << juce::String(realtime, 1) << std::endl
+                  << "us per frame  " << juce::String(load.totalSeconds * 1.0e6 / numFrames, 2) << std::endl
+                  << "average load  " << juce::String(load.getAverageLoad(settings.sampleRate) * 100.0, 2) << "%" << std::endl
+                  << "worst load    " << juce::String(load.worstLoad * 100.0, 2) << "%" << std::endl
+                  << "late blocks   " << load.deadlineMisses << std::endl;
+
+        if (load.deadlineMisses > 0)
+            juce::ConsoleApplication::fail(juce::String(load.deadlineMisses) + " blocks used more than "
+                                           + juce::String(maxLoad * 100.0, 1) + "% of their real-time budget");
+    }
+}
+
+juce::ConsoleApplication::Command Commands::getSpectralTest()
+{
+    return { "spectral",
+             "spectral [--seconds=<s>] [--max-load=<fraction>] [settings]",
+             "Checks that the spectral engine's frames keep up with real time",
+             "Runs the spectral crossover alone over noise on every lane, one block at a time, and times each block\n"
+             "against the time it takes to play. Reports how many times faster than real time it ran, the mean cost\n"
+             "of a frame, and the mean and worst block load. Fails if any block is over the limit.\n"
+             "  --seconds=<s>          length of audio to process, default 10\n"
+             "  --max-load=<fraction>  largest share of a block's real-time budget allowed, default 1\n"
+             + HeadlessHost::getSettingsHelp(),
+             runSpectralTest };
+}
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    Drives one instance of the processor in real time while another thread
+    changes its parameters as fast as it can, and checks the output for
+    invalid samples, clicks and late blocks.
+
+  ==============================================================================
+*/
+
+#include "Commands.h"
+#include "HeadlessHost.h"
+#include "OutputHealth.h"
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    /**
+    * Sets a random parameter to a random value, the way a fast automation lane or a dragged control would
+    */
+    void changeRandomParameter(CombinerAudioProcessor& processor, juce::Random& random)
+    {
+        static const char* const ids[]{ LINKED_ID, SLOPE_ID, LOPASS_FREQ_ID, HIPASS_FREQ_ID };
+
+        auto* parameter = processor.parameters.getParameter(ids[random.nextInt(juce::numElementsInArray(ids))]);
+        parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    /**
+    * Stores a random value straight into a raw parameter value, without telling the host, as the editor does
+    * for its slope buttons and when it keeps linked cutoffs together
+    */
+    void storeRandomRawValue(CombinerAudioProcessor& processor, juce::Random& random)
+    {
+        if (random.nextBool())
+        {
+            processor.parameters.getRawParameterValue(SLOPE_ID)->store(float(random.nextInt(slopes.size())));
+        }
+        else
+        {
+            const auto* cutoff = processor.parameters.getParameter(HIPASS_FREQ_ID);
+            processor.parameters.getRawParameterValue(HIPASS_FREQ_ID)->store(cutoff->convertFrom0to1(random.nextFloat()));
+        }
+    }
+
+    void runStressTest(const juce::ArgumentList& args)
+    {
+        const auto settings = HeadlessHost::readSettings(args);
+        const double seconds = HeadlessHost::getDoubleOption(args, "--seconds", 10.0);
+        const double interval = HeadlessHost::getDoubleOption(args, "--interval", 1.0);
+        const double clickRatio = HeadlessHost::getDoubleOption(args, "--click-ratio", 1.5);
+        const int numBlocks = juce::jmax(1, int(seconds * settings.sampleRate / settings.blockSize));
+
+        OutputHealthMonitor::Budget budget;
+        budget.maxWorstLoad = HeadlessHost::getDoubleOption(args, "--max-load", budget.maxWorstLoad);
+        budget.maxNonFinite = juce::uint64(juce::jmax(0, HeadlessHost::getIntOption(args, "--max-non-finite", 0)));
+        budget.maxDenormals = juce::uint64(juce::jmax(0, HeadlessHost::getIntOption(args, "--max-denormals", 0)));
+        budget.maxDiscontinuities = juce::uint64(juce::jmax(0, HeadlessHost::getIntOption(args, "--max-clicks", 0)));
+
+        auto processor = HeadlessHost::createInstance(settings);
+        auto buffer = HeadlessHost::createBuffer(*processor, settings.blockSize);
+        juce::MidiBuffer midi;
+        OutputHealthMonitor health;
+        const int numInputs = processor->getTotalNumInputChannels();
+        const int numOutputs = processor->getTotalNumOutputChannels();
+
+        // the sines step by at most about 0.1 a sample at 48 kHz, and the filters pass no larger a step than they are
+        // given, so any output step well beyond the largest input step is a click
+        health.setDiscontinuityThreshold(float(clickRatio), 0.0f);
+
+        std::cout << "Changing a parameter every " << interval << " ms for " << seconds << " s of "
+                  << engines[static_cast<int>(settings.engine)] << " engine audio in " << settings.blockSize
+                  << " sample blocks at " << settings.sampleRate << " Hz" << std::endl;
+
+        // the parameters change from another thread, as they would from the editor or the host's automation
+        std::atomic<bool> finished{ false };
+        juce::uint64 numChanges{ 0 }, numRawStores{ 0 };
+        std::thread hammer([&]
+        {
+            juce::Random random(1);
+            while (!finished.load())
+            {
+                // half the changes go through the host, half straight to the raw values as the editor stores them
+                if (random.nextBool())
+                {
+                    storeRandomRawValue(*processor, random);
+                    ++numRawStores;
+                }
+                else
+                    changeRandomParameter(*processor, random);
+
+                ++numChanges;
+                std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(interval));
+            }
+        });
+
+        // each block waits for its turn, so the parameters change as often per block as they would in a host
+        const auto blockDuration = std::chrono::duration<double>(settings.blockSize / settings.sampleRate);
+        auto nextBlock = std::chrono::steady_clock::now();
+        juce::int64 phase{ 0 };
+
+        for (int blockNo{ 0 }; blockNo < numBlocks; ++blockNo)
+        {
+            std::this_thread::sleep_until(nextBlock);
+            nextBlock += std::chrono::duration_cast<std::chrono::steady_clock::duration>(blockDuration);
+
+            HeadlessHost::fillWithSines(buffer, settings.sampleRate, phase);
+            health.beginBlock(buffer, numInputs);
+            processor->processBlock(buffer, midi);
+            health.endBlock(buffer, numOutputs);
+        }
+
+        finished = true;
+        hammer.join();
+
+        const auto stats = health.getStatistics();
+        const auto load = processor->getLoadMonitor().getStatistics();
+        std::cout << numChanges << " parameter changes, " << numRawStores << " of them stored as the editor does" << std::endl
+                  << "worst load    " << juce::String(load.worstLoad * 100.0, 1) << "%" << std::endl
+                  << "late blocks   " << load.deadlineMisses << std::endl
+                  << "NaN           " << stats.numNaNs << std::endl
+                  << "infinite      " << stats.numInfs << std::endl
+                  << "denormal      " << stats.numDenormals << std::endl
+                  << "clicks        " << stats.numDiscontinuities << ", largest jump " << juce::String(stats.largestJump, 3) << std::endl;
+
+        const auto failures = health.checkBudget(budget, load);
+        if (!failures.isEmpty())
+            juce::ConsoleApplication::fail("Over budget: " + failures.joinIntoString(", "));
+    }
+}
+
+juce::ConsoleApplication::Command Commands::getStressTest()
+{
+    return { "stress",
+             "stress [--seconds=<s>] [--interval=<ms>] [--click-ratio=<r>] [--max-load=<fraction>] [--max-non-finite=<n>] [--max-denormals=<n>] [--max-clicks=<n>] [settings]",
+             "Checks the output for invalid samples and clicks while parameters change rapidly",
+             "Plays two sines through one instance in real time while another thread sets the link, slope and cutoff\n"
+             "parameters to random values, half of the time through the host and half by storing the slope or the\n"
+             "cutoff straight into its raw value, as the editor does. Counts NaN, infinite and denormal output samples,\n"
+             "and clicks: output steps more than --click-ratio times the largest input step in the same block. Fails if\n"
+             "any count, or the worst block's share of its real-time budget, is over its limit.\n"
+             "  --seconds=<s>          length of audio to play, default 10\n"
+             "  --interval=<ms>        time between parameter changes, default 1\n"
+             "  --click-ratio=<r>      output step, as a multiple of the largest input step, that counts as a click, default 1.5\n"
+             "  --max-load=<fraction>  largest share of a block's real-time budget allowed, default 1\n"
+             "  --max-non-finite=<n>   NaN and infinite samples allowed, default 0\n"
+             "  --max-denormals=<n>    denormal samples allowed, default 0\n"
+             "  --max-clicks=<n>       clicks allowed, default 0\n"
+             + HeadlessHost::getSettingsHelp(),
+             runStressTest };
+}